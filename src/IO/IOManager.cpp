@@ -2,8 +2,6 @@
 #include <iostream>
 #include <chrono>
 #include <fstream>
-#include <cstdlib>
-#include <ctime>
 
 // Construtor
 IOManager::IOManager() :
@@ -12,8 +10,6 @@ IOManager::IOManager() :
     network_requesting(false),
     shutdown_flag(false)
 {
-    srand(time(nullptr));
-
     resultFile.open("output/resultados.dat", std::ios::app);
     outputFile.open("output/output.dat", std::ios::app);
 
@@ -40,6 +36,72 @@ void IOManager::registerProcessWaitingForIO(PCB* process) {
     waiting_processes.push_back(process);
 }
 
+void IOManager::setPageFaultHandler(PageFaultHandler handler) {
+    std::lock_guard<std::mutex> lock(page_fault_lock);
+    page_fault_handler = std::move(handler);
+}
+
+void IOManager::setUnblockCallback(UnblockCallback callback) {
+    std::lock_guard<std::mutex> lock(page_fault_lock);
+    unblock_callback = std::move(callback);
+}
+
+void IOManager::setSeed(uint64_t seed) {
+    std::lock_guard<std::mutex> lock(device_state_lock);
+    rng.seed(static_cast<std::mt19937::result_type>(seed));
+}
+
+void IOManager::setCostOverride(CostOverride override) {
+    std::lock_guard<std::mutex> lock(device_state_lock);
+    cost_override = std::move(override);
+}
+
+// Devolve o processo ao estado Ready e avisa o despachante
+void IOManager::markReady(PCB* process) {
+    UnblockCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(page_fault_lock);
+        callback = unblock_callback;
+    }
+    process->state = State::Ready;
+    if (callback) {
+        callback(process);
+    }
+}
+
+void IOManager::requestPageIn(PCB* process) {
+    {
+        std::lock_guard<std::mutex> lock(page_fault_lock);
+        page_fault_queue.push_back(process);
+    }
+    page_fault_cv.notify_one();
+}
+
+// Atende todos os page faults pendentes. Retorna true se algum foi atendido.
+bool IOManager::servicePageFaults() {
+    std::deque<PCB*> pending;
+    PageFaultHandler handler;
+    {
+        std::lock_guard<std::mutex> lock(page_fault_lock);
+        pending.swap(page_fault_queue);
+        handler = page_fault_handler;
+    }
+
+    for (PCB* process : pending) {
+        if (handler) {
+            handler(*process, process->faultAddress.load());
+        }
+        process->pendingPageFault.store(false);
+        markReady(process);
+    }
+    return !pending.empty();
+}
+
+StatHistogram IOManager::getServiceLatency() const {
+    std::lock_guard<std::mutex> lock(latency_lock);
+    return serviceLatency;
+}
+
 // Adiciona uma requisição criada à fila de processamento
 void IOManager::addRequest(std::unique_ptr<IORequest> request) {
     std::lock_guard<std::mutex> lock(queueLock);
@@ -48,19 +110,28 @@ void IOManager::addRequest(std::unique_ptr<IORequest> request) {
 
 void IOManager::managerLoop() {
     while (!shutdown_flag) {
-        // ETAPA 1: Simula os dispositivos solicitando uma operação
+        // ETAPA 0: Page faults têm prioridade (o processo está parado esperando a página)
+        servicePageFaults();
+
+        // ETAPA 1: Simula os dispositivos solicitando uma operação. Só há sorteio
+        // com processo esperando: a sequência de sorteios depende da ordem dos
+        // pedidos de I/O, e não de quantas voltas o laço deu no tempo de parede.
         {
+            std::lock_guard<std::mutex> wplock(waiting_processes_lock);
             std::lock_guard<std::mutex> lock(device_state_lock);
-            if (rand() % 100 == 0) {
-                if (!printer_requesting) {
-                    printer_requesting = true;
-                    // std::cout << "I/O Manager: [Impressora] está solicitando uma operação." << std::endl;
+            if (!waiting_processes.empty()) {
+                std::uniform_int_distribution<int> percent(0, 99);
+                if (percent(rng) == 0) {
+                    if (!printer_requesting) {
+                        printer_requesting = true;
+                        // std::cout << "I/O Manager: [Impressora] está solicitando uma operação." << std::endl;
+                    }
                 }
-            }
-            if (rand() % 50 == 0) {
-                if (!disk_requesting) {
-                    disk_requesting = true;
-                    // std::cout << "I/O Manager: [Disco] está solicitando uma operação." << std::endl;
+                if (percent(rng) < 2) {
+                    if (!disk_requesting) {
+                        disk_requesting = true;
+                        // std::cout << "I/O Manager: [Disco] está solicitando uma operação." << std::endl;
+                    }
                 }
             }
         }
@@ -88,7 +159,11 @@ void IOManager::managerLoop() {
                 if (new_request) {
                     new_request->process = process_to_service;
                     waiting_processes.erase(waiting_processes.begin());
-                    new_request->cost_cycles = std::chrono::milliseconds((rand() % 3 + 1) * 100);
+                    new_request->cost_cycles = std::chrono::milliseconds(
+                        (std::uniform_int_distribution<int>(1, 3)(rng)) * 100);
+                    if (cost_override) {
+                        cost_override(*process_to_service, new_request->cost_cycles);
+                    }
                 }
             }
         }
@@ -108,13 +183,17 @@ void IOManager::managerLoop() {
         }
 
         if (req_to_process) {
-            auto start = std::chrono::steady_clock::now();
             std::this_thread::sleep_for(req_to_process->cost_cycles);
-            auto end = std::chrono::steady_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+            // O processo paga o custo sorteado, e não o tempo medido do sleep
+            // (que varia com a carga do hospedeiro)
+            auto duration = req_to_process->cost_cycles.count();
 
             // Incrementa ciclos de I/O no PCB
             req_to_process->process->io_cycles.fetch_add(duration);
+            {
+                std::lock_guard<std::mutex> lock(latency_lock);
+                serviceLatency.sample(static_cast<uint64_t>(duration));
+            }
 
             std::cout << "I/O Manager: Processo " << req_to_process->process->pid 
                     << " executou '" << req_to_process->operation << "'\n";
@@ -124,9 +203,13 @@ void IOManager::managerLoop() {
             outputFile << req_to_process->process->pid << "," 
                     << req_to_process->operation << "," << duration << "ms\n";
 
-            req_to_process->process->state = State::Ready;
+            markReady(req_to_process->process);
         } else {
-            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            // Ocioso: acorda antes do fim do intervalo se chegar um page fault
+            std::unique_lock<std::mutex> lock(page_fault_lock);
+            page_fault_cv.wait_for(lock, std::chrono::milliseconds(20), [&]() {
+                return !page_fault_queue.empty();
+            });
         }
     }
 }
\ No newline at end of file
@@ -2,12 +2,17 @@
 #define IOMANAGER_HPP
 
 #include "../cpu/PCB.hpp"
+#include "../metrics/histogram.hpp"
 #include <vector>
 #include <mutex>
 #include <thread>
 #include <memory>
 #include <fstream>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <random>
 
 // Definição completa da estrutura IORequest
 struct IORequest {
@@ -25,9 +30,31 @@ public:
     // Método para um processo se registrar como "esperando por I/O"
     void registerProcessWaitingForIO(PCB* process);
 
+    // Page fault assíncrono: o processo (bloqueado, com faultAddress definido)
+    // espera o swap-in, executado pelo handler na thread do IOManager
+    using PageFaultHandler = std::function<void(PCB&, uint32_t)>;
+    void setPageFaultHandler(PageFaultHandler handler);
+    void requestPageIn(PCB* process);
+
+    // Avisado sempre que um processo bloqueado volta para o estado Ready
+    using UnblockCallback = std::function<void(PCB*)>;
+    void setUnblockCallback(UnblockCallback callback);
+
+    // Semente dos pedidos e custos dos dispositivos (fluxo IO_DEVICES)
+    void setSeed(uint64_t seed);
+
+    // Replay: devolve true e o custo gravado para o próximo I/O do processo
+    using CostOverride = std::function<bool(const PCB&, std::chrono::milliseconds&)>;
+    void setCostOverride(CostOverride override);
+
+    // Custo (ciclos cobrados) de cada operação de dispositivo atendida
+    StatHistogram getServiceLatency() const;
+
 private:
     void managerLoop();
     void addRequest(std::unique_ptr<IORequest> request);
+    bool servicePageFaults();
+    void markReady(PCB* process);
 
     // Fila de requisições prontas para serem executadas
     std::vector<std::unique_ptr<IORequest>> requests;
@@ -42,10 +69,22 @@ private:
     bool disk_requesting;
     bool network_requesting;
     std::mutex device_state_lock;
+    std::mt19937 rng; // Protegido por device_state_lock
+    CostOverride cost_override;
+
+    // Fila do disco de paginação (atendida antes dos dispositivos comuns)
+    std::deque<PCB*> page_fault_queue;
+    std::mutex page_fault_lock;
+    std::condition_variable page_fault_cv;
+    PageFaultHandler page_fault_handler;
+    UnblockCallback unblock_callback;
 
     bool shutdown_flag;
     std::thread managerThread;
 
+    StatHistogram serviceLatency;
+    mutable std::mutex latency_lock;
+
     std::ofstream resultFile;
     std::ofstream outputFile;
 };
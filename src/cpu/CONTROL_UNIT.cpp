@@ -1,5 +1,6 @@
 // control_unit_with_trace.cpp
 #include "CONTROL_UNIT.hpp"
+#include "coreCounters.hpp"
 #include <chrono>
 
 using namespace std;
@@ -70,8 +71,8 @@ static std::string toBinStr(uint32_t v, int width) {
     return s;
 }
 
-static inline void account_pipeline_cycle(PCB &p) { p.pipeline_cycles.fetch_add(1); }
-static inline void account_stage(PCB &p) { p.stage_invocations.fetch_add(1); }
+static inline void account_pipeline_cycle(PCB &p) { countEvent(p, CounterId::PIPELINE_CYCLES); }
+static inline void account_stage(PCB &p) { countEvent(p, CounterId::STAGE_INVOCATIONS); }
 
 std::string Control_Unit::resolveRegisterName(const std::string &bits) const {
     if (bits.empty()) {
@@ -234,6 +235,12 @@ uint32_t Control_Unit::FetchInstruction(ControlContext &context, int &capturedEp
     fetchedPC = pcValue;
 
     context.registers.mar.write(pcValue);
+
+    // Página de código fora da RAM: o PC não avança e o fetch para
+    if (raisePageFaultIfAbsent(context, pcValue, pcValue, capturedEpoch, false)) {
+        return 0;
+    }
+
     uint32_t instr = context.memManager.read(pcValue, context.process);
     context.registers.ir.write(instr);
 
@@ -592,6 +599,9 @@ void Control_Unit::Execute(Instruction_Data &data, ControlContext &context) {
 
     if (data.op == "LW") {
         if (assignAddress() && !data.targetRegisterName.empty()) {
+            if (raisePageFaultIfAbsent(context, data.effectiveAddress, data.pc, data.epoch, true)) {
+                return;
+            }
             std::lock_guard<std::mutex> guard(forwardingMutex);
             data.pendingMemoryRead = true;
             data.writeRegisterName = data.targetRegisterName;
@@ -602,6 +612,9 @@ void Control_Unit::Execute(Instruction_Data &data, ControlContext &context) {
 
     if (data.op == "SW") {
         if (assignAddress() && !data.targetRegisterName.empty()) {
+            if (raisePageFaultIfAbsent(context, data.effectiveAddress, data.pc, data.epoch, true)) {
+                return;
+            }
             data.pendingMemoryWrite = true;
             if (!readRegisterWithForwarding(data.targetRegisterName, data, context, data.storeValue)) {
                 throw std::runtime_error("Hazard forwarding falhou para " + data.targetRegisterName);
@@ -729,18 +742,63 @@ void Control_Unit::FlushPipeline(ControlContext &context) {
     loadHazardActive.store(false, std::memory_order_release);
 }
 
+// Com page faults assíncronos, verifica se a página de 'address' está na RAM.
+// Se não estiver, registra o fault e encerra a fatia de execução: as instruções
+// mais antigas drenam normalmente e o processo volta a partir de 'pc'.
+bool Control_Unit::raisePageFaultIfAbsent(ControlContext &context, uint32_t address, uint32_t pc,
+                                          int epoch, bool fromExecute) {
+    if (!context.memManager.asyncPageFaultsEnabled() ||
+        context.memManager.isResident(address, context.process)) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(context.pageFault.mutex);
+        bool replace = !context.pageFault.raised.load() ||
+                       (fromExecute && !context.pageFault.squashYounger.load());
+        if (replace) {
+            context.pageFault.address = address;
+            context.pageFault.pc = pc;
+            context.pageFault.epoch = epoch;
+            context.pageFault.squashYounger.store(fromExecute);
+            context.pageFault.raised.store(true);
+        }
+    }
+
+    if (fromExecute) {
+        // O LW que faltou não vai produzir valor: libera o Decode
+        clearLoadHazard("");
+    }
+    context.endExecution.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+// Políticas preemptivas: a fatia termina quando o processo esgota o quantum
+// (RR, Lottery, MLFQ, CFS e os de tempo real EDF/RM)
+static bool preemptsOnQuantum(int schedulerId) {
+    switch (schedulerId) {
+        case 0:
+        case 2:
+        case 5:
+        case 6:
+        case 7:
+        case 8:
+            return true;
+        default:
+            return false;
+    }
+}
+
 // A função Core agora utiliza um buffer entre estágios e cinco threads dedicadas
-void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IORequest>>* ioRequests, std::atomic<bool> &printLock, int schedulerId) {
+void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IORequest>>* ioRequests, std::atomic<bool> &printLock, int schedulerId, bool serialPipeline) {
     Control_Unit UC;
 
-    if (process.startTime.load() == 0) {
-    process.startTime.store(process.timeStamp); // ou use um contador global do simulador
-}
     std::atomic<bool> endProgram{false};
     std::atomic<bool> endExecution{false};
     std::mutex pcMutex;
+    PageFaultSignal pageFault;
 
-    ControlContext context{ process.regBank, memoryManager, *ioRequests, printLock, process, endProgram, endExecution };
+    ControlContext context{ process.regBank, memoryManager, *ioRequests, printLock, process, endProgram, endExecution, pageFault };
 
     PipelineRegister ifId;
     PipelineRegister idEx;
@@ -765,14 +823,23 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
                   << "\n";
     };
 
+    // O desvio descarta as instruções mais novas, mas não o token de drenagem
+    // que o Fetch já enviou (senão os estágios esperariam por ele para sempre)
     context.flushPipeline = [&]() {
-        ifId.flush();
-        idEx.flush();
+        ifId.flushInstructions();
+        idEx.flushInstructions();
     };
 
 
     std::atomic<int> issuedCycles{0};
 
+    // Pipeline serial: instrução buscada que ainda não saiu do pipeline
+    std::atomic<const Instruction_Data *> inFlight{nullptr};
+    auto retire = [&inFlight](const Instruction_Data *entry) {
+        const Instruction_Data *expected = entry;
+        inFlight.compare_exchange_strong(expected, nullptr);
+    };
+
     auto makeDrainToken = [&](bool programEndedFlag) {
         PipelineToken drain;
         drain.terminate = true;
@@ -781,6 +848,8 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
     };
 
     std::atomic<bool> stopWatchdog{false};
+    std::mutex watchdogMutex;
+    std::condition_variable watchdogCv; // Acorda o watchdog no fim da fatia, sem esperar o próximo período
 
     std::thread watchdogThread([&]() {
         // Disable watchdog for FCFS (schedulerId == 4) to prevent premature termination of long-running processes
@@ -792,7 +861,14 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
         uint64_t last = progressCounter.load(std::memory_order_relaxed);
         int stuckRounds = 0;
         while (!stopWatchdog.load(std::memory_order_relaxed)) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            {
+                std::unique_lock<std::mutex> lock(watchdogMutex);
+                if (watchdogCv.wait_for(lock, std::chrono::milliseconds(5), [&]() {
+                        return stopWatchdog.load(std::memory_order_relaxed);
+                    })) {
+                    break;
+                }
+            }
             uint64_t now = progressCounter.load(std::memory_order_relaxed);
             if (now == last) {
                 ++stuckRounds;
@@ -847,7 +923,10 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
         }
     });
 
+    // Cada estágio acumula os contadores da fatia no próprio bloco e descarrega
+    // no PCB ao sair (antes do join, então o núcleo já vê os totais)
     std::thread fetchThread([&]() {
+        CounterScope counters(process);
         bool drainSent = false;
         while (true) {
             if (endExecution.load(std::memory_order_relaxed)) {
@@ -866,6 +945,10 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
 
             uint32_t instruction = UC.FetchInstruction(context, fetchEpoch, fetchedPC);
 
+            if (pageFault.raised.load()) {
+                break;
+            }
+
             if (instruction == END_SENTINEL) {
                 // Adicione um END token e um drain; deixe o estágio Execute definir endProgram quando executar END.
                 PipelineToken token;
@@ -890,13 +973,30 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
             token.entry->pc = fetchedPC;
             token.valid = true;
             token.instruction = instruction;
+            if (serialPipeline) {
+                inFlight.store(token.entry);
+            }
             ifId.push(token);
             markProgress();
 
             issuedCycles.fetch_add(1, std::memory_order_relaxed);
             account_pipeline_cycle(process);
 
-            if ((schedulerId == 0 || schedulerId == 2 ) && issuedCycles.load(std::memory_order_relaxed) >= process.quantum) {
+            if (serialPipeline) {
+                while (inFlight.load() && !endExecution.load(std::memory_order_relaxed) &&
+                       !context.endProgram.load(std::memory_order_relaxed)) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(20));
+                }
+                // Desvio tomado: o PC mudou no Execute; IF e ID viram bolhas
+                if (!inFlight.load() && UC.global_epoch.load(std::memory_order_relaxed) != fetchEpoch) {
+                    issuedCycles.fetch_add(BRANCH_PENALTY_CYCLES, std::memory_order_relaxed);
+                    for (int bubble = 0; bubble < BRANCH_PENALTY_CYCLES; ++bubble) {
+                        account_pipeline_cycle(process);
+                    }
+                }
+            }
+
+            if (preemptsOnQuantum(schedulerId) && issuedCycles.load(std::memory_order_relaxed) >= process.quantum) {
                 endExecution.store(true, std::memory_order_relaxed);
                 break;
             }
@@ -911,8 +1011,11 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
         // Se uma preempção ocorreu (endExecution) sem o fim do programa, acorde o
         // pipeline com um token de drenagem e sinais de parada não destrutivos para que
         // os threads de estágio saiam de seus loops de espera sem descartar o trabalho em andamento.
+        // Em um page fault o token de drenagem percorre o pipeline inteiro: as
+        // instruções mais antigas precisam terminar antes de o processo bloquear.
         if (endExecution.load(std::memory_order_relaxed) &&
-            !context.endProgram.load(std::memory_order_relaxed)) {
+            !context.endProgram.load(std::memory_order_relaxed) &&
+            !pageFault.raised.load()) {
             ifId.push(makeDrainToken(false));
             markProgress();
             ifId.stop();
@@ -923,6 +1026,7 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
     });
 
     std::thread decodeThread([&]() {
+        CounterScope counters(process);
         PipelineToken token;
         while (ifId.pop(token)) {
             markProgress();
@@ -941,6 +1045,7 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
                 // hazard de load pendente desse epoch pode ser limpo com segurança; caso contrário,
                 // o Decode pode ficar parado para sempre esperando um load que nunca chegará ao MEM/WB.
                 UC.clearLoadHazard("");
+                retire(token.entry);
                 continue;
             }
 
@@ -950,6 +1055,7 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
             token.entry->epoch = local_epoch;
 
             if (local_epoch != UC.global_epoch.load(std::memory_order_relaxed)) {
+                retire(token.entry);
                 continue;
             }
 
@@ -978,6 +1084,7 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
     });
 
     std::thread executeThread([&]() {
+        CounterScope counters(process);
         PipelineToken token;
         while (idEx.pop(token)) {
             markProgress();
@@ -994,6 +1101,13 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
                 // A instrução ficou obsoleta após mudança de fluxo; limpe qualquer
                 // hazard de load pendente para o Decode não ficar parado.
                 UC.clearLoadHazard("");
+                retire(token.entry);
+                continue;
+            }
+
+            // Depois de um page fault no Execute, as instruções mais novas são descartadas
+            if (pageFault.squashYounger.load()) {
+                retire(token.entry);
                 continue;
             }
 
@@ -1004,6 +1118,7 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
     });
 
     std::thread memoryThread([&]() {
+        CounterScope counters(process);
         PipelineToken token;
         while (exMem.pop(token)) {
             markProgress();
@@ -1022,6 +1137,7 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
     });
 
     std::thread writeThread([&]() {
+        CounterScope counters(process);
         PipelineToken token;
         while (memWb.pop(token)) {
             markProgress();
@@ -1035,6 +1151,8 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
                 continue;
             }
             UC.Write_Back(*token.entry, context);
+            countEvent(process, CounterId::INSTRUCTIONS_RETIRED);
+            retire(token.entry);
         }
     });
 
@@ -1044,13 +1162,32 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
     memoryThread.join();
     writeThread.join();
 
-    stopWatchdog.store(true, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(watchdogMutex);
+        stopWatchdog.store(true, std::memory_order_relaxed);
+    }
+    watchdogCv.notify_all();
     watchdogThread.join();
 
     process.timeStamp += issuedCycles.load(std::memory_order_relaxed);
 
+    // Um fault do Fetch só vale se nenhum desvio mais antigo mudou o fluxo
+    // depois dele; nesse caso o PC já aponta para o destino do desvio.
+    bool blockedOnPage = false;
+    if (pageFault.raised.load() &&
+        (pageFault.squashYounger.load() || pageFault.epoch == UC.global_epoch.load())) {
+        context.registers.pc.write(pageFault.pc);
+        process.faultAddress.store(pageFault.address);
+        process.pendingPageFault.store(true);
+        process.async_page_faults.fetch_add(1);
+        blockedOnPage = true;
+    }
+
     if (context.endProgram.load(std::memory_order_relaxed)) {
+        process.pendingPageFault.store(false);
         process.state.store(State::Finished);
+    } else if (blockedOnPage) {
+        process.state.store(State::Blocked);
     } else if (process.state.load() != State::Blocked) {
         process.state.store(State::Ready);
     }
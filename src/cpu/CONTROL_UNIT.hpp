@@ -40,7 +40,25 @@ class MemoryManager;
 struct PCB;
 struct IORequest;
 
-void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IORequest>>* ioRequests, std::atomic<bool> &printLock, int schedulerId);
+// Page fault assíncrono levantado pelo pipeline. Um fault no Execute (LW/SW)
+// é mais antigo que qualquer fault do Fetch e o substitui; as instruções mais
+// novas que ele são descartadas.
+struct PageFaultSignal {
+    std::mutex mutex;
+    std::atomic<bool> raised{false};
+    std::atomic<bool> squashYounger{false};
+    uint32_t address = 0;  // Endereço lógico ausente
+    uint32_t pc = 0;       // Instrução reexecutada quando o processo voltar
+    int epoch = 0;         // Epoch do fetch (fault em caminho errado é descartado)
+};
+
+// serialPipeline: o Fetch só busca a próxima instrução depois que a anterior
+// sai do pipeline, e um desvio tomado custa BRANCH_PENALTY_CYCLES bolhas (IF e
+// ID, resolvido no EX). Sem busca no caminho errado nem acessos à memória
+// fora de ordem, os ciclos da fatia e o estado da cache não dependem do
+// escalonamento das threads do hospedeiro (simulation.deterministic).
+static constexpr int BRANCH_PENALTY_CYCLES = 2;
+void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IORequest>>* ioRequests, std::atomic<bool> &printLock, int schedulerId, bool serialPipeline = false);
 
 struct ControlContext {
     hw::REGISTER_BANK &registers;
@@ -50,6 +68,7 @@ struct ControlContext {
     PCB &process;
     std::atomic<bool> &endProgram;
     std::atomic<bool> &endExecution;
+    PageFaultSignal &pageFault;
     std::function<void()> flushPipeline;
 };
 
@@ -85,6 +104,8 @@ struct Control_Unit {
     void Memory_Access(Instruction_Data &data, ControlContext &context);
     void Write_Back(Instruction_Data &data, ControlContext &context);
     void FlushPipeline(ControlContext &context);
+    bool raisePageFaultIfAbsent(ControlContext &context, uint32_t address, uint32_t pc,
+                                int epoch, bool fromExecute);
     std::string resolveRegisterName(const std::string &bits) const;
     bool readRegisterWithForwarding(const std::string &name,
                                     Instruction_Data &current,
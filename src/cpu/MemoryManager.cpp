@@ -1,7 +1,35 @@
 #include "MemoryManager.hpp"
+#include "coreCounters.hpp"
 
+#include <algorithm>
 #include <iostream>
 
+namespace {
+// Contadores do processo antes de um acesso: a diferença depois dele dá os
+// ciclos cobrados e o nível mais lento alcançado
+struct AccessSnapshot {
+    uint64_t cycles;
+    uint64_t primary;
+    uint64_t secondary;
+};
+
+AccessSnapshot snapshotAccess(PCB &process) {
+    return {counterValue(process, CounterId::MEMORY_CYCLES),
+            counterValue(process, CounterId::PRIMARY_MEM_ACCESSES),
+            counterValue(process, CounterId::SECONDARY_MEM_ACCESSES)};
+}
+
+MemoryLevel deepestLevel(PCB &process, const AccessSnapshot &before) {
+    if (counterValue(process, CounterId::SECONDARY_MEM_ACCESSES) != before.secondary) {
+        return MemoryLevel::SWAP;
+    }
+    if (counterValue(process, CounterId::PRIMARY_MEM_ACCESSES) != before.primary) {
+        return MemoryLevel::RAM;
+    }
+    return MemoryLevel::CACHE;
+}
+} // namespace
+
 MemoryManager::MemoryManager(size_t mainMemorySize, size_t secondaryMemorySize, size_t cacheNumLines, size_t cacheLineSizeBytes, size_t pageSize, PolicyType framePolicy)
 {
     this->pageSize = pageSize;
@@ -31,49 +59,157 @@ MemoryManager::MemoryManager(size_t mainMemorySize, size_t secondaryMemorySize,
 uint32_t MemoryManager::read(uint32_t logicalAddress, PCB &process)
 {
     std::lock_guard<std::recursive_mutex> lock(memoryMutex);
-    process.mem_accesses_total.fetch_add(1);
-    process.mem_reads.fetch_add(1);
+    const AccessSnapshot before = snapshotAccess(process);
+    countEvent(process, CounterId::MEM_ACCESSES_TOTAL);
+    countEvent(process, CounterId::MEM_READS);
 
     uint32_t physicalAddress = translateLogicalToPhysical(logicalAddress, process);
 
     uint32_t data = L1_cache->read(physicalAddress, this, process);
 
-    process.cache_mem_accesses.fetch_add(1);
-    process.memory_cycles.fetch_add(process.memWeights.cache);
+    countEvent(process, CounterId::CACHE_MEM_ACCESSES);
+    countEvent(process, CounterId::MEMORY_CYCLES, process.memWeights.cache);
 
+    recordAccessLatency(process, counterValue(process, CounterId::MEMORY_CYCLES) - before.cycles,
+                        deepestLevel(process, before));
     return data;
 }
 
+// Chamado com memoryMutex: o histograma do núcleo não precisa de trava própria
+void MemoryManager::recordAccessLatency(PCB &process, uint64_t cycles, MemoryLevel level)
+{
+    size_t core = process.coresAssigned.empty() ? 0 : static_cast<size_t>(process.coresAssigned.back());
+    if (core >= accessLatency.size()) {
+        accessLatency.resize(core + 1);
+    }
+    accessLatency[core][static_cast<size_t>(level)].sample(cycles);
+}
+
+MemoryLatency MemoryManager::getMemoryLatency(size_t core) const
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    return core < accessLatency.size() ? accessLatency[core] : MemoryLatency{};
+}
+
+StatHistogram MemoryManager::getPageInLatency() const
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    return pageInLatency;
+}
+
 void MemoryManager::loadProcessData(uint32_t logicalAddress, uint32_t data, PCB &process)
 {
     std::lock_guard<std::recursive_mutex> lock(memoryMutex);
 
-    uint32_t physicalAddress = translateLogicalToPhysical(logicalAddress, process);
+    uint32_t physicalAddress = translateForWrite(logicalAddress, process);
 
     // std::cout << "[DEBUG] LoadProcessData: PID " << process.pid << " LogAddr " << logicalAddress 
     //           << " PhysAddr " << physicalAddress << " Data " << data << std::endl;
 
     mainMemory->WriteMem(physicalAddress, data);
 
-    process.mem_writes.fetch_add(1);
-    process.primary_mem_accesses.fetch_add(1);
-    process.mem_accesses_total.fetch_add(1);
-    process.memory_cycles.fetch_add(process.memWeights.primary);
+    countEvent(process, CounterId::MEM_WRITES);
+    countEvent(process, CounterId::PRIMARY_MEM_ACCESSES);
+    countEvent(process, CounterId::MEM_ACCESSES_TOTAL);
+    countEvent(process, CounterId::MEMORY_CYCLES, process.memWeights.primary);
+}
+
+void MemoryManager::loadProcessImage(uint32_t logicalAddress, const uint32_t *words, size_t count, PCB &process)
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+
+    size_t i = 0;
+    while (i < count)
+    {
+        uint32_t address = logicalAddress + static_cast<uint32_t>(i * 4);
+        uint32_t physicalAddress = translateForWrite(address, process);
+
+        // Palavras restantes dentro da mesma página
+        size_t pageRemaining = (this->pageSize - address % this->pageSize + 3) / 4;
+        size_t chunk = std::min(count - i, pageRemaining);
+        for (size_t k = 0; k < chunk; ++k)
+        {
+            mainMemory->WriteMem(physicalAddress + static_cast<uint32_t>(k * 4), words[i + k]);
+        }
+        i += chunk;
+    }
+
+    // Mesma contabilidade de 'count' chamadas a loadProcessData
+    countEvent(process, CounterId::MEM_WRITES, count);
+    countEvent(process, CounterId::PRIMARY_MEM_ACCESSES, count);
+    countEvent(process, CounterId::MEM_ACCESSES_TOTAL, count);
+    countEvent(process, CounterId::MEMORY_CYCLES, process.memWeights.primary * count);
+}
+
+void MemoryManager::setDemandPaging(bool enabled, bool shareOnFault)
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    demandPaging = enabled;
+    this->shareOnFault = shareOnFault;
+}
+
+bool MemoryManager::demandPagingEnabled() const
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    return demandPaging;
+}
+
+void MemoryManager::mapProcessImage(PCB &process, uint32_t logicalAddress, uint32_t codeStart, std::vector<uint32_t> words)
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+
+    BackingImage &image = backingImages[process.pid];
+    image.base = logicalAddress;
+    image.codeStart = codeStart;
+    image.words = std::move(words);
+    if (!image.words.empty())
+    {
+        uint64_t first = logicalAddress / pageSize;
+        uint64_t last = (logicalAddress + image.words.size() * 4 - 1) / pageSize;
+        demandMappedPages += last - first + 1;
+    }
+}
+
+const BackingImage *MemoryManager::backingFor(int pid, uint32_t pageNumber) const
+{
+    auto it = backingImages.find(pid);
+    if (it == backingImages.end() || it->second.words.empty())
+    {
+        return nullptr;
+    }
+    const BackingImage &image = it->second;
+    uint64_t pageStart = static_cast<uint64_t>(pageNumber) * pageSize;
+    uint64_t imageEnd = image.base + image.words.size() * 4;
+    return pageStart + pageSize > image.base && pageStart < imageEnd ? &image : nullptr;
+}
+
+DemandPagingStats MemoryManager::getDemandPagingStats() const
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+
+    DemandPagingStats stats;
+    stats.mappedPages = demandMappedPages;
+    stats.loadedPages = demandLoadedPages;
+    return stats;
 }
 
 void MemoryManager::write(uint32_t logicalAddress, uint32_t data, PCB &process)
 {
     std::lock_guard<std::recursive_mutex> lock(memoryMutex);
-    process.mem_accesses_total.fetch_add(1);
-    process.mem_writes.fetch_add(1);
+    const AccessSnapshot before = snapshotAccess(process);
+    countEvent(process, CounterId::MEM_ACCESSES_TOTAL);
+    countEvent(process, CounterId::MEM_WRITES);
 
-    uint32_t physicalAddress = translateLogicalToPhysical(logicalAddress, process);
+    uint32_t physicalAddress = translateForWrite(logicalAddress, process);
 
     L1_cache->write(physicalAddress, data, this, process);
 
     // std::cout << "Escrevendo na memória através da cache\n";
-    process.cache_mem_accesses.fetch_add(1);
-    process.memory_cycles.fetch_add(process.memWeights.cache);
+    countEvent(process, CounterId::CACHE_MEM_ACCESSES);
+    countEvent(process, CounterId::MEMORY_CYCLES, process.memWeights.cache);
+
+    recordAccessLatency(process, counterValue(process, CounterId::MEMORY_CYCLES) - before.cycles,
+                        deepestLevel(process, before));
 }
 
 int MemoryManager::allocateFreeFrame()
@@ -91,23 +227,114 @@ int MemoryManager::allocateFreeFrame()
             frameTable[i].ownerPID = -1;
             frameTable[i].pageNumber = 0;
 
-            // Inserção na política correta
-            if (currentFramePolicy == PolicyType::FIFO)
-            {
-                frameFIFO.push(i);
-            }
-            else if (currentFramePolicy == PolicyType::LRU)
-            {
-                frameLRU.push_front(i);
-                frameLruPos[i] = frameLRU.begin();
-            }
-
+            // A inserção na política de substituição é feita por quem mapeia
+            // o frame (swapInPage/copyOnWrite), uma única vez por frame
             return static_cast<int>(i);
         }
     }
     return -1;
 }
 
+// Frame livre ou, na falta dele, um frame liberado por swap-out
+int MemoryManager::obtainFrame()
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+
+    int frame = allocateFreeFrame();
+    if (frame == -1)
+    {
+        frame = swapOutPage();
+    }
+    return frame;
+}
+
+void MemoryManager::insertIntoFramePolicy(size_t frame)
+{
+    if (currentFramePolicy == PolicyType::FIFO)
+    {
+        frameFIFO.push(frame);
+    }
+    else if (currentFramePolicy == PolicyType::LRU)
+    {
+        frameLRU.push_front(frame);
+        frameLruPos[frame] = frameLRU.begin();
+    }
+}
+
+void MemoryManager::removeFromFramePolicy(size_t frame)
+{
+    if (currentFramePolicy == PolicyType::FIFO)
+    {
+        std::queue<size_t> newQueue;
+        while (!frameFIFO.empty())
+        {
+            size_t f = frameFIFO.front();
+            frameFIFO.pop();
+            if (f != frame)
+                newQueue.push(f);
+        }
+        frameFIFO = std::move(newQueue);
+    }
+    else if (currentFramePolicy == PolicyType::LRU)
+    {
+        frameLRU.remove(frame);
+        frameLruPos.erase(frame);
+    }
+}
+
+// Devolve o frame ao conjunto de livres
+void MemoryManager::releaseFrame(size_t frame)
+{
+    framesBitmap[frame] = false;
+    frameTable[frame] = FrameMetadata();
+    removeFromFramePolicy(frame);
+}
+
+// Remove o mapeamento (pid, página) do frame; o último a sair libera o frame
+void MemoryManager::detachSharer(size_t frame, int pid, uint32_t pageNumber)
+{
+    FrameMetadata &meta = frameTable[frame];
+
+    auto it = std::find(meta.sharers.begin(), meta.sharers.end(), std::make_pair(pid, pageNumber));
+    if (it != meta.sharers.end())
+    {
+        meta.sharers.erase(it);
+    }
+    meta.refCount = static_cast<uint32_t>(meta.sharers.size());
+
+    if (meta.sharers.empty())
+    {
+        releaseFrame(frame);
+        return;
+    }
+
+    // O dono "principal" passa a ser o próximo processo que ainda mapeia o frame
+    meta.ownerPID = meta.sharers.front().first;
+    meta.pageNumber = meta.sharers.front().second;
+}
+
+// Um frame de swap pode ser referenciado por várias páginas (frame compartilhado
+// que foi para o swap); só volta à lista de livres quando a última sai
+void MemoryManager::releaseSwapSlot(uint64_t swapID)
+{
+    auto it = swapMap.find(swapID);
+    if (it == swapMap.end())
+    {
+        return;
+    }
+
+    uint32_t swapFrame = it->second;
+    swapMap.erase(it);
+
+    auto ref = swapRefCount.find(swapFrame);
+    if (ref == swapRefCount.end() || --ref->second == 0)
+    {
+        if (ref != swapRefCount.end())
+            swapRefCount.erase(ref);
+        freeSwapFrames.push(swapFrame);
+    }
+}
+
 uint32_t MemoryManager::translateLogicalToPhysical(uint32_t logicalAddress, PCB &process)
 {
     std::lock_guard<std::recursive_mutex> lock(memoryMutex);
@@ -121,12 +348,7 @@ uint32_t MemoryManager::translateLogicalToPhysical(uint32_t logicalAddress, PCB
 
     if (pageFault)
     {
-        int freeFrame = allocateFreeFrame();
-
-        if (freeFrame == -1)
-        {
-            freeFrame = swapOutPage();
-        }
+        int freeFrame = obtainFrame();
 
         swapInPage(pageNumber, process, freeFrame);
 
@@ -137,10 +359,16 @@ uint32_t MemoryManager::translateLogicalToPhysical(uint32_t logicalAddress, PCB
 
         process.pageTable[pageNumber] = entry;
 
-        process.secondary_mem_accesses.fetch_add(1);
-        process.mem_accesses_total.fetch_add(1);
-        process.mem_writes.fetch_add(1);
-        process.memory_cycles.fetch_add(process.memWeights.secondary);
+        if (frameTable[freeFrame].pristine && shareOnFault)
+        {
+            const BackingImage *image = backingFor(process.pid, pageNumber);
+            shareLoadedPage(process, pageNumber, static_cast<uint64_t>(pageNumber) * pageSize >= image->codeStart);
+        }
+
+        countEvent(process, CounterId::SECONDARY_MEM_ACCESSES);
+        countEvent(process, CounterId::MEM_ACCESSES_TOTAL);
+        countEvent(process, CounterId::MEM_WRITES);
+        countEvent(process, CounterId::MEMORY_CYCLES, process.memWeights.secondary);
     }
 
     uint32_t physicalFrame = process.pageTable[pageNumber].frameNumber;
@@ -167,12 +395,128 @@ uint32_t MemoryManager::translateLogicalToPhysical(uint32_t logicalAddress, PCB
     return physicalAddress;
 }
 
+void MemoryManager::setAsyncPageFaults(bool enabled)
+{
+    asyncPageFaults.store(enabled);
+}
+
+bool MemoryManager::asyncPageFaultsEnabled() const
+{
+    return asyncPageFaults.load();
+}
+
+bool MemoryManager::isResident(uint32_t logicalAddress, PCB &process)
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+
+    auto it = process.pageTable.find(logicalAddress / this->pageSize);
+    return it != process.pageTable.end() && it->second.valid;
+}
+
+// Executado pela thread do IOManager: faz o swap-in fora do núcleo
+void MemoryManager::servicePageFault(uint32_t logicalAddress, PCB &process)
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    uint64_t before = counterValue(process, CounterId::MEMORY_CYCLES);
+    translateLogicalToPhysical(logicalAddress, process);
+    pageInLatency.sample(counterValue(process, CounterId::MEMORY_CYCLES) - before);
+}
+
+// Tradução para escrita: se o frame estiver compartilhado, a página recebe
+// antes uma cópia privada (copy-on-write)
+uint32_t MemoryManager::translateForWrite(uint32_t logicalAddress, PCB &process)
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+
+    uint32_t physicalAddress = translateLogicalToPhysical(logicalAddress, process);
+
+    uint32_t pageNumber = logicalAddress / this->pageSize;
+    size_t frame = process.pageTable[pageNumber].frameNumber;
+
+    if (frameTable[frame].refCount > 1)
+    {
+        uint32_t newFrame = copyOnWrite(pageNumber, process);
+        physicalAddress = (newFrame * this->pageSize) + (logicalAddress % this->pageSize);
+        frame = newFrame;
+    }
+    // Depois da escrita o conteúdo (talvez só na cache) deixa de ser o da imagem
+    frameTable[frame].pristine = false;
+
+    return physicalAddress;
+}
+
+uint32_t MemoryManager::copyOnWrite(uint32_t pageNumber, PCB &process)
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+
+    size_t oldFrame = process.pageTable[pageNumber].frameNumber;
+    uint32_t oldBase = static_cast<uint32_t>(oldFrame * pageSize);
+
+    // As linhas da cache deste processo referenciam o frame antigo
+    L1_cache->invalidatePage(oldBase, pageSize, process.pid, this, &process);
+
+    // Copia antes de obter o novo frame: o swap-out pode escolher justamente o frame compartilhado
+    std::vector<uint32_t> content(pageSize);
+    for (size_t i = 0; i < pageSize; ++i) {
+        content[i] = mainMemory->ReadMem(oldBase + i);
+    }
+
+    detachSharer(oldFrame, process.pid, pageNumber);
+
+    int newFrame = obtainFrame();
+    uint32_t newBase = static_cast<uint32_t>(newFrame * pageSize);
+    for (size_t i = 0; i < pageSize; ++i) {
+        mainMemory->WriteMem(newBase + i, content[i]);
+    }
+
+    FrameMetadata &meta = frameTable[newFrame];
+    meta.ownerPID = process.pid;
+    meta.pageNumber = pageNumber;
+    meta.valid = true;
+    meta.dirty = false;
+    meta.refCount = 1;
+    meta.sharers = {{process.pid, pageNumber}};
+    meta.pristine = false;
+    insertIntoFramePolicy(static_cast<size_t>(newFrame));
+
+    PageTableEntry &entry = process.pageTable[pageNumber];
+    entry.frameNumber = static_cast<uint32_t>(newFrame);
+    entry.valid = true;
+
+    // A cópia é uma transferência de página dentro da RAM
+    cowFaults++;
+    countEvent(process, CounterId::COW_FAULTS);
+    countEvent(process, CounterId::PRIMARY_MEM_ACCESSES);
+    countEvent(process, CounterId::MEM_ACCESSES_TOTAL);
+    countEvent(process, CounterId::MEMORY_CYCLES, process.memWeights.primary);
+
+    return static_cast<uint32_t>(newFrame);
+}
+
 void MemoryManager::setCacheReplacementPolicy(PolicyType policy)
 {
     std::lock_guard<std::recursive_mutex> lock(memoryMutex);
     L1_cache->setReplacementPolicy(policy);
 }
 
+void MemoryManager::setCacheWritePolicy(WritePolicy policy, bool writeAllocate, size_t writeBufferEntries)
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    L1_cache->setWritePolicy(policy, writeAllocate, writeBufferEntries);
+}
+
+void MemoryManager::setCacheOrganization(size_t associativity, size_t victimEntries)
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    L1_cache->setOrganization(associativity, victimEntries);
+}
+
+void MemoryManager::setCachePartitioning(CachePartitionMode mode, uint64_t repartitionInterval)
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    L1_cache->setPartitioning(mode, repartitionInterval);
+}
+
 // Função chamada pela cache para write-back, ou seja, escrita na memória física diretamente
 void MemoryManager::writeToPhysical(uint32_t physicalAddress, uint32_t data, PCB &process)
 {
@@ -181,20 +525,39 @@ void MemoryManager::writeToPhysical(uint32_t physicalAddress, uint32_t data, PCB
     if (physicalAddress < mainMemoryLimit)
     {
         mainMemory->WriteMem(physicalAddress, data);
-        process.primary_mem_accesses.fetch_add(1);
-        process.mem_accesses_total.fetch_add(1);
-        process.memory_cycles.fetch_add(process.memWeights.primary);
+        countEvent(process, CounterId::PRIMARY_MEM_ACCESSES);
+        countEvent(process, CounterId::MEM_ACCESSES_TOTAL);
+        countEvent(process, CounterId::MEMORY_CYCLES, process.memWeights.primary);
     }
     else
     {
         uint32_t secondaryAddress = physicalAddress - mainMemoryLimit;
         secondaryMemory->WriteMem(secondaryAddress, data);
-        process.secondary_mem_accesses.fetch_add(1);
-        process.mem_accesses_total.fetch_add(1);
-        process.memory_cycles.fetch_add(process.memWeights.secondary);
+        countEvent(process, CounterId::SECONDARY_MEM_ACCESSES);
+        countEvent(process, CounterId::MEM_ACCESSES_TOTAL);
+        countEvent(process, CounterId::MEMORY_CYCLES, process.memWeights.secondary);
     }
 }
 
+// Drenagem assíncrona do write buffer: contabiliza o acesso, mas não soma ciclos ao processo
+void MemoryManager::postedWriteToPhysical(uint32_t physicalAddress, uint32_t data, PCB *process)
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+
+    if (physicalAddress < mainMemoryLimit)
+    {
+        mainMemory->WriteMem(physicalAddress, data);
+        if (process) countEvent(*process, CounterId::PRIMARY_MEM_ACCESSES);
+    }
+    else
+    {
+        secondaryMemory->WriteMem(physicalAddress - mainMemoryLimit, data);
+        if (process) countEvent(*process, CounterId::SECONDARY_MEM_ACCESSES);
+    }
+
+    if (process) countEvent(*process, CounterId::MEM_ACCESSES_TOTAL);
+}
+
 // Função chamada pela cache para read, ou seja, leitura na memória física diretamente
 uint32_t MemoryManager::readFromPhysical(uint32_t physicalAddress, PCB &process)
 {
@@ -205,24 +568,37 @@ uint32_t MemoryManager::readFromPhysical(uint32_t physicalAddress, PCB &process)
     if (physicalAddress < mainMemoryLimit)
     {
         data = mainMemory->ReadMem(physicalAddress);
-        process.primary_mem_accesses.fetch_add(1);
-        process.mem_reads.fetch_add(1);
-        process.mem_accesses_total.fetch_add(1);
-        process.memory_cycles.fetch_add(process.memWeights.primary);
+        countEvent(process, CounterId::PRIMARY_MEM_ACCESSES);
+        countEvent(process, CounterId::MEM_READS);
+        countEvent(process, CounterId::MEM_ACCESSES_TOTAL);
+        countEvent(process, CounterId::MEMORY_CYCLES, process.memWeights.primary);
     }
     else
     {
         uint32_t secondaryAddress = physicalAddress - mainMemoryLimit;
         data = secondaryMemory->ReadMem(secondaryAddress);
-        process.secondary_mem_accesses.fetch_add(1);
-        process.mem_reads.fetch_add(1);
-        process.mem_accesses_total.fetch_add(1);
-        process.memory_cycles.fetch_add(process.memWeights.secondary);
+        countEvent(process, CounterId::SECONDARY_MEM_ACCESSES);
+        countEvent(process, CounterId::MEM_READS);
+        countEvent(process, CounterId::MEM_ACCESSES_TOTAL);
+        countEvent(process, CounterId::MEMORY_CYCLES, process.memWeights.secondary);
     }
 
     return data;
 }
 
+void MemoryManager::registerProcess(PCB *process)
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    processTable[process->pid] = process;
+}
+
+PCB *MemoryManager::getProcessByPID(int pid) const
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    auto it = processTable.find(pid);
+    return it != processTable.end() ? it->second : nullptr;
+}
+
 void MemoryManager::freeProcessPages(PCB &process)
 {
     std::lock_guard<std::recursive_mutex> lock(memoryMutex);
@@ -231,50 +607,156 @@ void MemoryManager::freeProcessPages(PCB &process)
     {
         // Sempre remover do swap, se existir
         uint64_t swapID = ((uint64_t)process.pid << 32) | page;
-        if (swapMap.count(swapID)) {
-            freeSwapFrames.push(swapMap[swapID]);
-            swapMap.erase(swapID);
-            // std::cout << "[DEBUG] Swap Free (ProcessEnd): PID " << process.pid << " Page " << page 
-            //           << " -> SwapFrame " << swapMap[swapID] << ". Remaining: " << freeSwapFrames.size() << std::endl;
-        }
+        releaseSwapSlot(swapID);
 
         if (!entry.valid)
         {
             continue;
         }
 
-        size_t frame = entry.frameNumber;
+        // Frames compartilhados só são liberados quando o último processo sai
+        detachSharer(entry.frameNumber, process.pid, page);
+    }
 
-        framesBitmap[frame] = false;
-        frameTable[frame].valid = false;
-        frameTable[frame].ownerPID = -1;
+    process.pageTable.clear();
+    backingImages.erase(process.pid);
+}
 
-        // Remover da FIFO
-        if (currentFramePolicy == PolicyType::FIFO)
+// Compartilhamento por conteúdo. Chamado logo após a carga do programa,
+// antes da execução: a carga escreve direto na RAM, então o conteúdo dos
+// frames ainda é o definitivo (não há linhas sujas na cache).
+void MemoryManager::mergeIdenticalPages(PCB &process, uint32_t codeStart)
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+
+    auto mapsProcess = [&](const FrameMetadata &meta) {
+        return std::any_of(meta.sharers.begin(), meta.sharers.end(),
+                           [&](const std::pair<int, uint32_t> &s) { return s.first == process.pid; });
+    };
+
+    // Índice de conteúdo dos frames residentes de outros processos
+    std::unordered_map<uint64_t, std::vector<size_t>> contentIndex;
+    for (size_t frame = 0; frame < totalFrames; ++frame)
+    {
+        const FrameMetadata &meta = frameTable[frame];
+        if (meta.valid && !meta.sharers.empty() && !mapsProcess(meta))
         {
-            std::queue<size_t> newQueue;
-            while (!frameFIFO.empty())
-            {
-                size_t f = frameFIFO.front();
-                frameFIFO.pop();
-                if (f != frame)
-                    newQueue.push(f);
-            }
-            frameFIFO = std::move(newQueue);
+            contentIndex[hashFrame(frame)].push_back(frame);
+        }
+    }
+
+    for (auto &[page, entry] : process.pageTable)
+    {
+        if (!entry.valid || frameTable[entry.frameNumber].refCount != 1)
+        {
+            continue;
         }
-        else if (currentFramePolicy == PolicyType::LRU)
+
+        auto candidates = contentIndex.find(hashFrame(entry.frameNumber));
+        if (candidates == contentIndex.end())
+        {
+            continue;
+        }
+
+        for (size_t target : candidates->second)
         {
-            auto it = frameLruPos.find(frame);
-            if (it != frameLruPos.end())
+            FrameMetadata &meta = frameTable[target];
+            if (!meta.valid || mapsProcess(meta) || !framesEqual(entry.frameNumber, target))
             {
-                frameLRU.erase(it->second);
-                frameLruPos.erase(frame);
+                continue;
             }
+
+            bool isCode = static_cast<uint64_t>(page) * pageSize >= codeStart;
+
+            releaseFrame(entry.frameNumber);
+            entry.frameNumber = static_cast<uint32_t>(target);
+
+            meta.sharers.emplace_back(process.pid, page);
+            meta.refCount = static_cast<uint32_t>(meta.sharers.size());
+            meta.codePage = meta.codePage || isCode;
+
+            mergedPages++;
+            if (isCode)
+                mergedCodePages++;
+            break;
         }
     }
+}
 
-    process.pageTable.clear();
+// Paginação sob demanda: a página acabou de ser preenchida com a imagem.
+// Só frames que nunca foram escritos servem de alvo, porque o conteúdo na RAM
+// de um frame já escrito pode estar desatualizado em relação à cache.
+void MemoryManager::shareLoadedPage(PCB &process, uint32_t pageNumber, bool isCode)
+{
+    PageTableEntry &entry = process.pageTable[pageNumber];
+    for (size_t target = 0; target < totalFrames; ++target)
+    {
+        FrameMetadata &meta = frameTable[target];
+        if (target == entry.frameNumber || !meta.valid || !meta.pristine || meta.sharers.empty() ||
+            !framesEqual(entry.frameNumber, target))
+        {
+            continue;
+        }
+        bool mapsProcess = std::any_of(meta.sharers.begin(), meta.sharers.end(),
+                                       [&](const std::pair<int, uint32_t> &s) { return s.first == process.pid; });
+        if (mapsProcess)
+        {
+            continue;
+        }
 
+        releaseFrame(entry.frameNumber);
+        entry.frameNumber = static_cast<uint32_t>(target);
+
+        meta.sharers.emplace_back(process.pid, pageNumber);
+        meta.refCount = static_cast<uint32_t>(meta.sharers.size());
+        meta.codePage = meta.codePage || isCode;
+
+        mergedPages++;
+        if (isCode)
+            mergedCodePages++;
+        return;
+    }
+}
+
+// FNV-1a sobre as palavras do frame
+uint64_t MemoryManager::hashFrame(size_t frame) const
+{
+    uint64_t hash = 1469598103934665603ULL;
+    uint32_t base = static_cast<uint32_t>(frame * pageSize);
+    for (size_t i = 0; i < pageSize; ++i)
+    {
+        hash ^= mainMemory->ReadMem(base + i);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool MemoryManager::framesEqual(size_t a, size_t b) const
+{
+    uint32_t baseA = static_cast<uint32_t>(a * pageSize);
+    uint32_t baseB = static_cast<uint32_t>(b * pageSize);
+    for (size_t i = 0; i < pageSize; ++i)
+    {
+        if (mainMemory->ReadMem(baseA + i) != mainMemory->ReadMem(baseB + i))
+            return false;
+    }
+    return true;
+}
+
+PageSharingStats MemoryManager::getPageSharingStats() const
+{
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+
+    PageSharingStats stats;
+    stats.mergedPages = mergedPages;
+    stats.mergedCodePages = mergedCodePages;
+    stats.cowFaults = cowFaults;
+    for (const auto &meta : frameTable)
+    {
+        if (meta.valid && meta.refCount > 1)
+            stats.sharedFrames++;
+    }
+    return stats;
 }
 
 int MemoryManager::chooseVictimFrame()
@@ -311,8 +793,18 @@ int MemoryManager::swapOutPage()
 
     FrameMetadata &meta = frameTable[victim];
 
-    // 1. Escrever no swap se a página estava válida (e sujeita a ser dirty)
-    if (meta.valid)
+    // 0. Invalida a cache para este frame antes da cópia: linhas sujas e
+    // escritas pendentes no write buffer precisam estar na RAM. A tag da
+    // cache inclui o PID, então cada processo que mapeia o frame é tratado.
+    for (const auto &[pid, page] : meta.sharers)
+    {
+        L1_cache->invalidatePage(victim * pageSize, pageSize, pid, this, getProcessByPID(pid));
+    }
+
+    // 1. Escrever no swap se a página estava válida (e sujeita a ser dirty).
+    // Um frame compartilhado ocupa um único frame de swap, referenciado por
+    // todos os mapeamentos.
+    if (meta.valid && !meta.sharers.empty())
     {
         if (freeSwapFrames.empty()) {
             throw std::runtime_error("SwapOut: Memória secundária cheia!");
@@ -321,8 +813,12 @@ int MemoryManager::swapOutPage()
         uint32_t swapFrame = freeSwapFrames.front();
         freeSwapFrames.pop();
 
-        uint64_t swapKey = (uint64_t(meta.ownerPID) << 32) | meta.pageNumber;
-        swapMap[swapKey] = swapFrame;
+        for (const auto &[pid, page] : meta.sharers)
+        {
+            uint64_t swapKey = (uint64_t(pid) << 32) | page;
+            swapMap[swapKey] = swapFrame;
+        }
+        swapRefCount[swapFrame] = static_cast<uint32_t>(meta.sharers.size());
         
         uint32_t baseSwapAddr = swapFrame * pageSize;
         // Copia byte a byte (ou word a word, dependendo da interpretação de pageSize)
@@ -333,18 +829,18 @@ int MemoryManager::swapOutPage()
         }
     }
 
-    // 2. INVALIDAR entrada da PAGE TABLE do processo
-    PCB *proc = PCB::getProcessByPID(meta.ownerPID);
-    if (proc)
+    // 2. INVALIDAR entrada da PAGE TABLE de cada processo que mapeia o frame
+    for (const auto &[pid, page] : meta.sharers)
     {
-        auto it = proc->pageTable.find(meta.pageNumber);
+        PCB *proc = getProcessByPID(pid);
+        if (!proc)
+            continue;
+
+        auto it = proc->pageTable.find(page);
         if (it != proc->pageTable.end())
             it->second.valid = false;
     }
 
-    // Invalidate Cache for this frame
-    L1_cache->invalidatePage(victim * pageSize, pageSize, meta.ownerPID, this, proc);
-
     // 3. Limpar frame
     meta = FrameMetadata();
 
@@ -359,6 +855,7 @@ void MemoryManager::swapInPage(uint32_t pageNumber, PCB& process, int freeFrame)
 
     // size_t wordsPerPage = pageSize / sizeof(uint32_t);
     uint32_t baseAddress = static_cast<uint32_t>(freeFrame * pageSize);
+    bool pristine = false;
 
     if (swapMap.count(swapID))
     {
@@ -371,9 +868,8 @@ void MemoryManager::swapInPage(uint32_t pageNumber, PCB& process, int freeFrame)
             mainMemory->WriteMem(baseAddress + i, val);
         }
 
-        // Libera o frame de swap
-        freeSwapFrames.push(swapFrame);
-        swapMap.erase(swapID);
+        // Libera o frame de swap (se nenhuma outra página o referencia)
+        releaseSwapSlot(swapID);
     }
     else
     {
@@ -381,6 +877,25 @@ void MemoryManager::swapInPage(uint32_t pageNumber, PCB& process, int freeFrame)
         for (size_t i = 0; i < pageSize; ++i) {
             mainMemory->WriteMem(baseAddress + i, 0xFC000000);
         }
+
+        // Primeiro acesso a uma página da imagem: copia as palavras que caem nela
+        if (const BackingImage *image = backingFor(process.pid, pageNumber))
+        {
+            uint64_t pageStart = static_cast<uint64_t>(pageNumber) * pageSize;
+            uint64_t pageEnd = pageStart + pageSize;
+            uint64_t first = pageStart > image->base ? (pageStart - image->base + 3) / 4 : 0;
+            for (uint64_t i = first; i < image->words.size(); ++i)
+            {
+                uint64_t address = image->base + i * 4;
+                if (address >= pageEnd)
+                {
+                    break;
+                }
+                mainMemory->WriteMem(baseAddress + static_cast<uint32_t>(address - pageStart), image->words[i]);
+            }
+            pristine = true;
+            demandLoadedPages++;
+        }
     }
 
     FrameMetadata &meta = frameTable[freeFrame];
@@ -388,16 +903,12 @@ void MemoryManager::swapInPage(uint32_t pageNumber, PCB& process, int freeFrame)
     meta.pageNumber = pageNumber;
     meta.valid = true;
     meta.dirty = false;
+    meta.refCount = 1;
+    meta.sharers = {{process.pid, pageNumber}};
+    meta.codePage = false;
+    meta.pristine = pristine;
 
-    if (currentFramePolicy == PolicyType::FIFO)
-    {
-        frameFIFO.push(static_cast<size_t>(freeFrame));
-    }
-    else if (currentFramePolicy == PolicyType::LRU)
-    {
-        frameLRU.push_front(static_cast<size_t>(freeFrame));
-        frameLruPos[static_cast<size_t>(freeFrame)] = frameLRU.begin();
-    }
+    insertIntoFramePolicy(static_cast<size_t>(freeFrame));
 }
 
 size_t MemoryManager::getMainMemoryUsage() const {
@@ -424,6 +935,46 @@ size_t MemoryManager::getCacheCapacity() const {
     return L1_cache->getCapacity();
 }
 
+CacheWriteStats MemoryManager::getCacheWriteStats() const {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    return L1_cache->getWriteStats();
+}
+
+std::vector<CacheSetStats> MemoryManager::getCacheSetStats() const {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    return L1_cache->getSetStats();
+}
+
+CacheMissBreakdown MemoryManager::getCacheMissBreakdown() const {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    return L1_cache->getMissBreakdown();
+}
+
+uint64_t MemoryManager::getCacheVictimHits() const {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    return L1_cache->getVictimHits();
+}
+
+size_t MemoryManager::getCacheAssociativity() const {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    return L1_cache->getAssociativity();
+}
+
+std::map<int, CacheOccupancy> MemoryManager::getCacheOccupancy() const {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    return L1_cache->getOccupancy();
+}
+
+uint64_t MemoryManager::getCacheRepartitions() const {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    return L1_cache->getRepartitions();
+}
+
+CachePartitionMode MemoryManager::getCachePartitionMode() const {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    return L1_cache->getPartitionMode();
+}
+
 size_t MemoryManager::getSecondaryMemoryCapacity() const {
     return totalSwapFrames;
 }
\ No newline at end of file
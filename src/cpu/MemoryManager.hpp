@@ -1,14 +1,21 @@
 #ifndef MEMORY_MANAGER_HPP
 #define MEMORY_MANAGER_HPP
 
+#include <array>
+#include <atomic>
 #include <memory>
 #include <stdexcept>
 #include <mutex>
+#include <utility>
+#include <vector>
 #include "../memory/MAIN_MEMORY.hpp"
 #include "../memory/SECONDARY_MEMORY.hpp"
 #include "../memory/replacementPolicy.hpp"
 #include "cache/cache.hpp"
+#include "cache/writeBuffer.hpp"
+#include "cache/cacheStats.hpp"
 #include "PCB.hpp"
+#include "../metrics/histogram.hpp"
 
 // Forward declarations para evitar ciclo de includes
 class PCB;
@@ -19,8 +26,41 @@ struct FrameMetadata {
     uint32_t pageNumber = 0;     // Número da página mapeada
     bool dirty = false;          // Página foi modificada?
     bool valid = false;          // Frame está sendo usado?
+
+    // Compartilhamento por conteúdo: cada (PID, página) mapeada no frame.
+    // Com refCount > 1 o frame é somente leitura e uma escrita gera cópia (COW).
+    uint32_t refCount = 0;
+    std::vector<std::pair<int, uint32_t>> sharers;
+    bool codePage = false;       // Página só de instruções (compartilhamento de código)
+    bool pristine = false;       // Preenchida a partir da imagem do programa e nunca escrita
+};
+
+// Estatísticas de compartilhamento de páginas
+struct PageSharingStats {
+    uint64_t mergedPages = 0;    // Páginas que passaram a apontar para um frame existente
+    uint64_t mergedCodePages = 0;
+    uint64_t cowFaults = 0;      // Escritas em frame compartilhado (cópia privada)
+    uint64_t sharedFrames = 0;   // Frames com refCount > 1 no momento da consulta
+};
+
+// Programa registrado como objeto de apoio (paginação sob demanda)
+struct BackingImage {
+    uint32_t base = 0;             // Endereço lógico da primeira palavra
+    uint32_t codeStart = 0;        // Páginas a partir daqui contam como código
+    std::vector<uint32_t> words;
 };
 
+struct DemandPagingStats {
+    uint64_t mappedPages = 0;      // Páginas cobertas pelas imagens registradas
+    uint64_t loadedPages = 0;      // Páginas preenchidas no primeiro acesso
+};
+
+// Nível mais lento que um acesso alcançou
+enum class MemoryLevel : uint8_t { CACHE, RAM, SWAP, COUNT };
+
+// Latência por acesso (ciclos cobrados do processo), um histograma por nível
+using MemoryLatency = std::array<StatHistogram, static_cast<size_t>(MemoryLevel::COUNT)>;
+
 class MemoryManager
 {
 public:
@@ -35,14 +75,48 @@ public:
     uint32_t read(uint32_t LogicalAddress, PCB &process);
     void write(uint32_t LogicalAddress, uint32_t data, PCB &process);
     void loadProcessData(uint32_t logicalAddress, uint32_t data, PCB &process);
+    // Grava 'count' palavras consecutivas: uma tradução por página em vez de uma por palavra
+    void loadProcessImage(uint32_t logicalAddress, const uint32_t *words, size_t count, PCB &process);
+
+    // Paginação sob demanda: a carga só registra a imagem e cada página é
+    // preenchida no primeiro acesso (swapInPage). Com 'shareOnFault', a página
+    // recém-preenchida é compartilhada com um frame idêntico ainda não escrito.
+    void setDemandPaging(bool enabled, bool shareOnFault);
+    bool demandPagingEnabled() const;
+    void mapProcessImage(PCB &process, uint32_t logicalAddress, uint32_t codeStart, std::vector<uint32_t> words);
+    DemandPagingStats getDemandPagingStats() const;
 
     void setCacheReplacementPolicy(PolicyType policy);
+    void setCacheWritePolicy(WritePolicy policy, bool writeAllocate, size_t writeBufferEntries);
+    void setCacheOrganization(size_t associativity, size_t victimEntries);
+    void setCachePartitioning(CachePartitionMode mode, uint64_t repartitionInterval);
+
+    // Page faults assíncronos: o pipeline consulta isResident antes do acesso e,
+    // se a página não estiver na RAM, bloqueia o processo em vez de fazer o swap
+    // no próprio núcleo. O IOManager chama servicePageFault depois.
+    void setAsyncPageFaults(bool enabled);
+    bool asyncPageFaultsEnabled() const;
+    bool isResident(uint32_t logicalAddress, PCB &process);
+    void servicePageFault(uint32_t logicalAddress, PCB &process);
 
     // Função auxiliar para o write-back da cache
     void writeToPhysical(uint32_t address, uint32_t data, PCB &process);
+    // Escrita postada pelo write buffer: gera tráfego mas não atrasa o processo
+    void postedWriteToPhysical(uint32_t address, uint32_t data, PCB *process);
     uint32_t readFromPhysical(uint32_t physicalAddress, PCB &process);
     void freeProcessPages(PCB &process);
 
+    // Processos desta memória, por PID: o swap-out invalida a page table de
+    // cada processo que mapeia o frame. O registro é por instância porque
+    // vários simuladores podem rodar no mesmo processo (lote de experimentos).
+    void registerProcess(PCB *process);
+    PCB *getProcessByPID(int pid) const;
+
+    // Compartilha as páginas residentes do processo com frames de conteúdo
+    // idêntico; páginas a partir de 'codeStart' são contabilizadas como código
+    void mergeIdenticalPages(PCB &process, uint32_t codeStart);
+    PageSharingStats getPageSharingStats() const;
+
     int chooseVictimFrame();
     int swapOutPage();
     void swapInPage(uint32_t pageNumber, PCB& process, int freeFrame);
@@ -53,8 +127,21 @@ public:
     size_t getCacheUsage() const;
 
     size_t getCacheCapacity() const;
+    CacheWriteStats getCacheWriteStats() const;
+    std::vector<CacheSetStats> getCacheSetStats() const;
+    CacheMissBreakdown getCacheMissBreakdown() const;
+    uint64_t getCacheVictimHits() const;
+    size_t getCacheAssociativity() const;
+    std::map<int, CacheOccupancy> getCacheOccupancy() const;
+    uint64_t getCacheRepartitions() const;
+    CachePartitionMode getCachePartitionMode() const;
     size_t getSecondaryMemoryCapacity() const;
 
+    // Latências dos acessos feitos pelo núcleo 'core' (vazio se ele não acessou)
+    MemoryLatency getMemoryLatency(size_t core) const;
+    // Ciclos de cada swap-in atendido por servicePageFault
+    StatHistogram getPageInLatency() const;
+
 private:
     std::unique_ptr<MAIN_MEMORY> mainMemory;
     std::unique_ptr<SECONDARY_MEMORY> secondaryMemory;
@@ -64,19 +151,49 @@ private:
     mutable std::recursive_mutex memoryMutex;
 
     uint32_t translateLogicalToPhysical(uint32_t logicalAddress, PCB &process);
+    void recordAccessLatency(PCB &process, uint64_t cycles, MemoryLevel level);
+    uint32_t translateForWrite(uint32_t logicalAddress, PCB &process);
+    uint32_t copyOnWrite(uint32_t pageNumber, PCB &process);
     int allocateFreeFrame();
+    int obtainFrame();
+    void releaseFrame(size_t frame);
+    void insertIntoFramePolicy(size_t frame);
+    void removeFromFramePolicy(size_t frame);
+    void detachSharer(size_t frame, int pid, uint32_t pageNumber);
+    void releaseSwapSlot(uint64_t swapID);
+    uint64_t hashFrame(size_t frame) const;
+    bool framesEqual(size_t a, size_t b) const;
 
     std::vector<FrameMetadata> frameTable;
+    std::unordered_map<int, PCB *> processTable;
 
     // std::unordered_map<uint64_t, SwappedPage> swapSpace;
     std::queue<uint32_t> freeSwapFrames;
     std::unordered_map<uint64_t, uint32_t> swapMap; // (pid << 32 | page) -> swapFrameIndex
+    std::unordered_map<uint32_t, uint32_t> swapRefCount; // swapFrameIndex -> páginas que o usam
+
+    uint64_t mergedPages = 0;
+    uint64_t mergedCodePages = 0;
+    uint64_t cowFaults = 0;
+
+    const BackingImage *backingFor(int pid, uint32_t pageNumber) const;
+    void shareLoadedPage(PCB &process, uint32_t pageNumber, bool isCode);
+    bool demandPaging = false;
+    bool shareOnFault = false;
+    std::unordered_map<int, BackingImage> backingImages; // PID -> imagem do programa
+    uint64_t demandMappedPages = 0;
+    uint64_t demandLoadedPages = 0;
 
     std::queue<size_t> frameFIFO;
     std::list<size_t> frameLRU; 
     std::unordered_map<size_t, std::list<size_t>::iterator> frameLruPos;
 
     PolicyType currentFramePolicy;
+
+    std::atomic<bool> asyncPageFaults{false};
+
+    std::vector<MemoryLatency> accessLatency; // Por núcleo da fatia que fez o acesso
+    StatHistogram pageInLatency;
 };
 
 #endif // MEMORY_MANAGER_HPP
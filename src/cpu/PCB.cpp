@@ -1,30 +1,43 @@
 #include "PCB.hpp"
 
-std::unordered_map<int, PCB*> PCB::processTable;
-std::mutex PCB::processTableMutex;
-
 PCB::~PCB() {
-    unregisterProcess(this->pid);
+    ObjectPool<ProgramOutput>::instance().destroy(output.load());
 }
 
-void PCB::registerProcess(PCB* proc) {
-    if (!proc) return;
-    std::lock_guard<std::mutex> lock(processTableMutex);
-    processTable[proc->pid] = proc;
+void PCB::setRealtime(uint64_t period, uint64_t deadline, uint64_t wcet, int jobs) {
+    if (period == 0) {
+        rt.reset();
+        return;
+    }
+    if (!rt) {
+        rt = makePooled<RealtimeState>();
+    }
+    rt->rtPeriod = period;
+    rt->rtDeadline = deadline;
+    rt->rtWcet = wcet;
+    rt->rtJobs = jobs;
+    rt->absoluteDeadline = rt->releaseTime + deadline;
 }
 
-void PCB::unregisterProcess(int pid) {
-    std::lock_guard<std::mutex> lock(processTableMutex);
-    processTable.erase(pid);
+void PCB::appendProgramOutput(const std::string &line) {
+    ProgramOutput *current = output.load();
+    if (current == nullptr) {
+        ProgramOutput *created = ObjectPool<ProgramOutput>::instance().create();
+        if (output.compare_exchange_strong(current, created)) {
+            current = created;
+        } else {
+            ObjectPool<ProgramOutput>::instance().destroy(created);
+        }
+    }
+    std::lock_guard<std::mutex> lock(current->mutex);
+    current->lines.push_back(line);
 }
 
-PCB* PCB::getProcessByPID(int pid) {
-    std::lock_guard<std::mutex> lock(processTableMutex);
-    auto it = processTable.find(pid);
-    return (it != processTable.end()) ? it->second : nullptr;
+std::vector<std::string> PCB::snapshotProgramOutput() const {
+    ProgramOutput *current = output.load();
+    if (current == nullptr) {
+        return {};
+    }
+    std::lock_guard<std::mutex> lock(current->mutex);
+    return current->lines;
 }
-
-void PCB::appendProgramOutput(const std::string &line) {
-    std::lock_guard<std::mutex> lock(outputMutex);
-    programOutput.push_back(line);
-}
\ No newline at end of file
@@ -5,6 +5,10 @@
   Definição do bloco de controle de processo (PCB) usado pelo simulador da CPU.
   Centraliza: identificação do processo, prioridade, quantum, pesos de memória e
   contadores de instrumentação de pipeline/memória.
+
+  Layout: os campos lidos pelas filas de prontos ficam juntos no começo; o estado
+  de tempo real, a residência na MLFQ e a saída do programa ficam em blocos de
+  pool criados sob demanda, para que 10^6 processos ociosos caibam na memória.
 */
 #include <unordered_map>
 #include <mutex>
@@ -12,8 +16,10 @@
 #include <atomic>
 #include <cstdint>
 #include <vector>
-#include <mutex>
+#include <array>
+#include <chrono>
 #include "cache/cache.hpp"
+#include "objectPool.hpp"
 #include "datapath/REGISTER_BANK.hpp" // necessidade de objeto completo dentro do PCB
 
 
@@ -31,27 +37,89 @@ struct MemWeights {
     uint64_t secondary = 10; // custo por acesso à memória secundária
 };
 
+// Número máximo de níveis da MLFQ (scheduling.mlfq.levels é limitado a este valor)
+constexpr int MLFQ_MAX_LEVELS = 8;
+
 struct PageTableEntry {
     uint32_t frameNumber; 
     bool valid;           
     bool dirty;          
 };
 
+// ---------------------------------------------------------------------------
+// Parte fria do PCB: blocos do ObjectPool criados só para os processos que
+// precisam deles. Com 10^6 processos a maioria nunca é periódica, não passa
+// pela MLFQ e não imprime nada.
+// ---------------------------------------------------------------------------
+
+// Tempo real (metadata period/deadline/wcet). Cada job reexecuta o programa
+// a partir de entryPC; tempos em ciclos simulados do núcleo.
+struct RealtimeState {
+    uint64_t rtPeriod = 0;            // Período (> 0)
+    uint64_t rtDeadline = 0;          // Deadline relativo (padrão: o período)
+    uint64_t rtWcet = 0;              // Pior caso declarado (0 = desconhecido)
+    int rtJobs = 0;                   // Jobs a liberar (0 = scheduling.realtime.jobs)
+    int jobsCompleted = 0;
+    uint64_t releaseTime = 0;         // Liberação do job atual
+    uint64_t absoluteDeadline = 0;    // releaseTime + rtDeadline
+    uint64_t jobCycles = 0;           // Ciclos já executados pelo job atual
+    uint64_t releaseWaitCycles = 0;   // Entre o fim de um job e a liberação do próximo
+    int deadlineMisses = 0;
+    int64_t maxLateness = INT64_MIN;  // término - deadline (negativo = folga)
+    uint64_t totalTardiness = 0;      // Soma dos atrasos positivos
+    uint64_t maxJobCycles = 0;        // Maior tempo de execução observado de um job
+    int64_t minLaxity = INT64_MAX;    // deadline - despacho - WCET restante
+    int64_t laxitySum = 0;
+    uint64_t laxitySamples = 0;
+};
+
+// MLFQ: residência por nível. Criado na primeira entrada em uma fila MLFQ.
+struct MlfqStats {
+    std::chrono::steady_clock::time_point readySince{};       // Entrada na fila de prontos
+    std::array<std::atomic<uint64_t>, MLFQ_MAX_LEVELS> slices{};    // Fatias executadas por nível
+    std::array<std::atomic<uint64_t>, MLFQ_MAX_LEVELS> cycles{};    // Ciclos executados por nível
+    std::array<std::atomic<uint64_t>, MLFQ_MAX_LEVELS> waitNs{};    // Espera na fila até o despacho
+};
+
+// Saída lógica gerada pelo programa (ex.: instruções PRINT)
+struct ProgramOutput {
+    std::vector<std::string> lines;
+    std::mutex mutex;
+};
+
 struct PCB {
+    // --- Núcleo quente: lido pelas filas de prontos e pelo despacho ---
     int pid = 0;
     int tickets = 1;
-    std::vector<int> coresAssigned;
-    std::string name;
     int quantum = 0;
     int timeStamp = 0;
     int priority = 0;
+    int sliceStart = 0; // timeStamp no início da fatia atual (MLFQ e CFS)
+    std::atomic<State> state{State::Ready};
+    std::atomic<int> mlfqLevel{0};                            // MLFQ: nível atual (0 = mais prioritário)
+    int mlfqSliceLevel = 0;                                   // Nível em que a fatia atual começou
+    std::atomic<uint64_t> vruntime{0}; // CFS: tempo virtual de execução (ciclos em ponto fixo, ponderados pelo peso)
+    uint64_t readyAt = 0;              // Instante em que ficou pronto pela última vez
+    uint64_t lastRunEnd = 0;           // Fim da última fatia, no relógio simulado
+    uint64_t cacheWayMask = 0; // Vias da cache em que o processo pode alocar (0 = todas)
+    uint32_t entryPC = 0;      // Início do código, usado ao liberar o próximo job
     int instructions;
 
-    std::atomic<State> state{State::Ready};
-    
-    ~PCB();
+    // Page fault assíncrono pendente: endereço lógico que o IOManager deve trazer para a RAM
+    std::atomic<bool> pendingPageFault{false};
+    std::atomic<uint32_t> faultAddress{0};
+
+    // Blocos frios (nulos quando o processo não usa)
+    PoolPtr<RealtimeState> rt;   // Só para tarefas periódicas
+    PoolPtr<MlfqStats> mlfq;     // Só com scheduling.algorithm = MLFQ
 
+    // --- Estado arquitetural e de memória ---
     hw::REGISTER_BANK regBank;
+    std::unordered_map<uint32_t, PageTableEntry> pageTable;
+    MemWeights memWeights;
+
+    std::vector<int> coresAssigned;
+    std::string name;
 
     // Contadores de acesso à memória
     std::atomic<uint64_t> primary_mem_accesses{0};
@@ -68,6 +136,7 @@ struct PCB {
     std::atomic<uint64_t> stage_invocations{0};
     std::atomic<uint64_t> mem_reads{0};
     std::atomic<uint64_t> mem_writes{0};
+    std::atomic<uint64_t> instructions_retired{0}; // Instruções que chegaram ao WB
 
     // Novos contadores
     std::atomic<uint64_t> cache_write_hits{0};
@@ -76,6 +145,12 @@ struct PCB {
     std::atomic<uint64_t> cache_write_misses{0};
     std::atomic<uint64_t> cache_read_misses{0};
     std::atomic<uint64_t> cache_misses{0};
+    std::atomic<uint64_t> write_buffer_stall_cycles{0}; // Ciclos esperando o write buffer cheio
+    std::atomic<uint64_t> victim_cache_hits{0};         // Misses da L1 atendidos pela victim cache
+    std::atomic<uint64_t> cow_faults{0};                // Escritas que copiaram uma página compartilhada
+    std::atomic<uint64_t> async_page_faults{0};         // Page faults atendidos pelo IOManager (processo bloqueado)
+    std::atomic<uint64_t> migrations{0};                // Fatias iniciadas em um núcleo diferente do anterior
+    std::atomic<uint64_t> migration_cycles{0};          // Penalidade de aquecimento de cache cobrada nas migrações
     std::atomic<uint64_t> io_cycles{1};
 
     // Novas métricas
@@ -87,60 +162,38 @@ struct PCB {
     std::atomic<uint64_t> waitingTime{0};      // turnaroundTime - burstTime
     std::atomic<uint64_t> responseTime{0};     // startTime - arrivalTime
 
-    std::unordered_map<uint32_t, PageTableEntry> pageTable;
+    // Linha do tempo simulada (relógio global, em ciclos)
+    std::atomic<uint64_t> serviceCycles{0};    // Soma das fatias (pipeline + memória + migração)
+    std::atomic<uint64_t> blockedCycles{0};    // Tempo simulado bloqueado em I/O ou swap-in
 
-    MemWeights memWeights;
+    PCB() = default;
+    ~PCB();
+    PCB(const PCB &) = delete;
+    PCB &operator=(const PCB &) = delete;
 
-    // Saída lógica gerada pelo programa (ex.: instruções PRINT)
-    std::vector<std::string> programOutput;
-    mutable std::mutex outputMutex;
+    bool isPeriodic() const { return rt != nullptr; }
 
-    void appendProgramOutput(const std::string &line);
+    // Cria (ou descarta, com period = 0) o bloco de tempo real
+    void setRealtime(uint64_t period, uint64_t deadline, uint64_t wcet, int jobs);
 
-    std::vector<std::string> snapshotProgramOutput() const {
-        std::lock_guard<std::mutex> lock(outputMutex);
-        return programOutput;
+    // Cria o bloco da MLFQ na primeira vez que o processo entra em uma fila MLFQ
+    MlfqStats &mlfqStats() {
+        if (!mlfq) {
+            mlfq = makePooled<MlfqStats>();
+        }
+        return *mlfq;
     }
 
+    void appendProgramOutput(const std::string &line);
+    std::vector<std::string> snapshotProgramOutput() const;
+
     int totalTimeExecution() const {
-        return (timeStamp + memory_cycles.load() + io_cycles.load());
+        return (timeStamp + memory_cycles.load() + io_cycles.load() + migration_cycles.load());
     }
 
-    // Registra o processo (deve ser chamado quando o PCB é criado/registrado no sistema)
-    static void registerProcess(PCB* proc);
-
-    // Remove o processo do registro (deve ser chamado quando o processo termina)
-    static void unregisterProcess(int pid);
-
-    // Retorna nullptr se não encontrado
-    static PCB* getProcessByPID(int pid);
-
-private:
-    static std::unordered_map<int, PCB*> processTable;
-    static std::mutex processTableMutex;
+   private:
+    // Criado na primeira linha impressa; atômico porque a leitura pode vir de outra thread
+    std::atomic<ProgramOutput *> output{nullptr};
 };
 
-// Contabilizar cache
-inline void contabiliza_cache(PCB &pcb, bool hit, std::string access = "read") {
-    if (hit) {
-        if (access == "read") {
-            pcb.cache_read_accesses++;
-            pcb.cache_read_hits++;
-        } else if (access == "write") {
-            pcb.cache_write_accesses++;
-            pcb.cache_write_hits++;
-        }
-        pcb.cache_hits++;
-    } else {
-        if (access == "read") {
-            pcb.cache_read_accesses++;
-            pcb.cache_read_misses++;
-        } else if (access == "write") {
-            pcb.cache_write_accesses++;
-            pcb.cache_write_misses++;
-        }
-        pcb.cache_misses++;
-    }
-}
-
 #endif // PCB_HPP
\ No newline at end of file
@@ -30,6 +30,16 @@ void PipelineRegister::flush() {
     cv_.notify_all();
 }
 
+void PipelineRegister::flushInstructions() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (hasToken_ && stored_.terminate) {
+        return;
+    }
+    hasToken_ = false;
+    stored_ = PipelineToken{};
+    cv_.notify_all();
+}
+
 void PipelineRegister::stop() {
     std::lock_guard<std::mutex> lock(mutex_);
     // Notifica quaisquer wait() sem descartar um token possivelmente em trânsito. Isso é
@@ -46,6 +46,8 @@ public:
     void push(const PipelineToken &token);
     bool pop(PipelineToken &out);
     void flush();
+    // Descarta apenas instruções; um token de drenagem em trânsito é mantido
+    void flushInstructions();
     void stop();
     bool empty() const;
 
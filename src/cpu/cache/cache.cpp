@@ -1,17 +1,28 @@
 #include "cache.hpp"
+#include "../coreCounters.hpp"
 
 Cache::Cache(size_t numLines, size_t wordsPerLine, PolicyType policy)
         : capacity(numLines),
         wordsPerLine(wordsPerLine),
         cache_hits(0),
         cache_misses(0),
-        currentPolicy(policy) {
+        currentPolicy(policy),
+        writePolicy(WritePolicy::WRITE_BACK),
+        writeAllocate(true),
+        writeBuffer(0, wordsPerLine),
+        partitionMode(CachePartitionMode::NONE),
+        repartitionInterval(1),
+        accessesSinceRepartition(0),
+        repartitions(0) {
    
     // Inicializa linhas da cache
     lines.reserve(capacity);
     for (size_t i = 0; i < capacity; ++i) {
         lines.emplace_back(wordsPerLine);
     }
+
+    // Layout padrão: totalmente associativa, sem victim cache
+    setOrganization(0, 0);
 }
 
 Cache::~Cache() {
@@ -20,8 +31,9 @@ Cache::~Cache() {
     // Limpa estruturas necessárias
     lruPos.clear();
     lruOrder.clear();
-    fifoQueue = std::queue<size_t>();
+    fifoQueue.clear();
     blockTagToLine.clear();
+    victimCache.clear();
     lines.clear();
 }
 
@@ -34,6 +46,7 @@ AddressDecoded Cache::decodeAddress(uint32_t address, int pid) const {
     // Shift PID to upper bits and combine with block address
     size_t blockAddr = address / blockSizeBytes;
     info.tag = (static_cast<size_t>(pid) << 24) | blockAddr;
+    info.setIndex = blockAddr % numSets;
     info.wordOffset = (address % blockSizeBytes) / sizeof(uint32_t);
 
     return info;
@@ -46,23 +59,24 @@ uint32_t Cache::read(uint32_t address, MemoryManager* mem, PCB& process) {
     AddressDecoded info = decodeAddress(address, process.pid);
 
     auto it = blockTagToLine.find(info.tag);
+    recordAccess(info, it != blockTagToLine.end(), process.pid);
     if (it != blockTagToLine.end()) {
         // HIT
         cache_hits++;
-        contabiliza_cache(process, true, "read");
+        contabiliza_cache(process, true, CacheAccess::READ);
         size_t lineIndex = it->second;
 
         updateReplacementPolicy(lineIndex);
+        // Barramento livre durante o hit: drena uma entrada do write buffer
+        drainBackground(mem, process);
         return lines[lineIndex].data[info.wordOffset];
     } else {
         // MISS
         cache_misses++;
-        contabiliza_cache(process, false, "read");
+        contabiliza_cache(process, false, CacheAccess::READ);
 
-        // Carrega o bloco da memória principal para a cache
-        size_t lineIndex = getLineToEvict();
-        evictLine(lineIndex, mem, process);
-        loadBlock(info.tag, lineIndex, mem, process);
+        // Carrega o bloco (victim cache ou memória principal) para a cache
+        size_t lineIndex = allocateLine(info, mem, process);
 
         return lines[lineIndex].data[info.wordOffset];
     }
@@ -75,78 +89,141 @@ void Cache::write(uint32_t address, uint32_t data, MemoryManager* mem, PCB& proc
     AddressDecoded info = decodeAddress(address, process.pid);
 
     auto it = blockTagToLine.find(info.tag);
+    recordAccess(info, it != blockTagToLine.end(), process.pid);
     size_t lineIndex;
 
     if (it != blockTagToLine.end()) {
         // HIT
         cache_hits++;
-        contabiliza_cache(process, true, "write");
+        contabiliza_cache(process, true, CacheAccess::WRITE);
         lineIndex = it->second;
 
         updateReplacementPolicy(lineIndex);
-    } else {
+        drainBackground(mem, process);
+    } else if (writeAllocate) {
         // MISS → write-allocate
         cache_misses++;
-        contabiliza_cache(process, false, "write");
+        contabiliza_cache(process, false, CacheAccess::WRITE);
 
-        // Carrega o bloco da memória principal para a cache
-        lineIndex = getLineToEvict();
-        evictLine(lineIndex, mem, process);
-        loadBlock(info.tag, lineIndex, mem, process);
+        // Carrega o bloco (victim cache ou memória principal) para a cache
+        lineIndex = allocateLine(info, mem, process);
+    } else {
+        // MISS → no-write-allocate: a escrita segue direto para a memória
+        cache_misses++;
+        contabiliza_cache(process, false, CacheAccess::WRITE);
+        enqueueWord(address, data, mem, process);
+        return;
     }
 
     lines[lineIndex].data[info.wordOffset] = data;
 
-    lines[lineIndex].dirty = true;
+    if (writePolicy == WritePolicy::WRITE_THROUGH) {
+        enqueueWord(address, data, mem, process);
+    } else {
+        lines[lineIndex].dirty = true;
+    }
+}
+
+// Escolhe a linha do conjunto, expulsa a vítima e traz o bloco requisitado.
+// Um hit na victim cache troca o bloco de volta sem acessar a memória.
+size_t Cache::allocateLine(const AddressDecoded& info, MemoryManager* mem, PCB& process) {
+    uint64_t wayMask = wayMaskFor(process);
+    occupancy[process.pid].wayMask = wayMask;
+    size_t lineIndex = getLineToEvict(info.setIndex, wayMask);
+
+    if (lines[lineIndex].valid) {
+        setStats[info.setIndex].evictions++;
+    }
+
+    VictimEntry fromVictim;
+    bool victimHit = victimCache.take(info.tag, fromVictim);
+
+    evictLine(lineIndex, mem, process, true);
+
+    if (victimHit) {
+        setStats[info.setIndex].victimHits++;
+        countEvent(process, CounterId::VICTIM_CACHE_HITS);
+        installBlock(info.tag, lineIndex, fromVictim.data, fromVictim.dirty);
+    } else {
+        loadBlock(info.tag, lineIndex, mem, process);
+    }
+
+    return lineIndex;
+}
+
+// Instala um bloco já disponível (vindo da victim cache) na linha
+void Cache::installBlock(size_t blockTag, size_t lineIndex, const std::vector<uint32_t>& data, bool dirty) {
+    CacheLine& line = lines[lineIndex];
+
+    line.data = data;
+    line.tag = blockTag;
+    line.valid = true;
+    line.dirty = dirty;
+
+    blockTagToLine[blockTag] = lineIndex;
+    trackOwnership(blockTag, true);
+    updateReplacementPolicy(lineIndex);
+
+    if (currentPolicy == PolicyType::FIFO) {
+        fifoQueue[lineIndex / ways].push_back(lineIndex);
+    }
 }
 
 // Carrega um bloco da memória principal para a cache
 void Cache::loadBlock(size_t blockTag, size_t lineIndex, MemoryManager* mem, PCB& process) {
     CacheLine& line = lines[lineIndex];
 
-    size_t blockSizeBytes = wordsPerLine * sizeof(uint32_t);
-    // Extract the address part from the tag (lower 24 bits) since upper bits contain PID
-    uint32_t blockAddr = blockTag & 0xFFFFFF;
-    uint32_t baseAddress = blockAddr * blockSizeBytes;
+    uint32_t baseAddress = blockBaseAddress(blockTag);
 
     for (size_t i = 0; i < wordsPerLine; i++) {
         uint32_t wordAddress = baseAddress + (i * sizeof(uint32_t));
         line.data[i] = mem->readFromPhysical(wordAddress, process);
     }
 
+    // Escritas ainda pendentes no write buffer são mais recentes que a memória
+    writeBuffer.forward(baseAddress, line.data);
+
     line.tag = blockTag;
     line.valid = true;
     line.dirty = false;
 
     // Atualiza mapeamento bloco → linha
     blockTagToLine[blockTag] = lineIndex;
+    trackOwnership(blockTag, true);
 
     // Atualiza política de substituição
     updateReplacementPolicy(lineIndex);
 
     if (currentPolicy == PolicyType::FIFO) {
-        fifoQueue.push(lineIndex);
+        fifoQueue[lineIndex / ways].push_back(lineIndex);
     }
 }
 
-// Força escrita do bloco se dirty
-void Cache::evictLine(size_t lineIndex, MemoryManager* mem, PCB& process) {
+// Força escrita do bloco se dirty. Com 'toVictimCache' a linha expulsa vai
+// para a victim cache e só é escrita na memória quando sair de lá.
+void Cache::evictLine(size_t lineIndex, MemoryManager* mem, PCB& process, bool toVictimCache) {
     CacheLine& line = lines[lineIndex];
 
-    if (line.valid && line.dirty) {
-        size_t blockSizeBytes = wordsPerLine * sizeof(uint32_t);
-        // Extract the address part from the tag (lower 24 bits) since upper bits contain PID
-        uint32_t blockAddr = line.tag & 0xFFFFFF;
-        uint32_t baseAddress = blockAddr * blockSizeBytes;
+    if (line.valid && toVictimCache && victimCache.enabled()) {
+        VictimEntry entry;
+        entry.tag = line.tag;
+        entry.data = line.data;
+        entry.dirty = line.dirty;
 
-        for (size_t i = 0; i < wordsPerLine; ++i) {
-            uint32_t wordAddress = baseAddress + (i * sizeof(uint32_t));
-            mem->writeToPhysical(wordAddress, line.data[i], process);
+        VictimEntry displaced;
+        if (victimCache.insert(std::move(entry), displaced) && displaced.dirty) {
+            enqueueBlock(blockBaseAddress(displaced.tag), displaced.data, mem, process);
+            writeStats.writebackBlocks++;
         }
+    } else if (line.valid && line.dirty) {
+        // Write-back: a linha suja vai para o write buffer (ou direto à memória)
+        enqueueBlock(blockBaseAddress(line.tag), line.data, mem, process);
+        writeStats.writebackBlocks++;
     }
 
     if (line.valid) {
         blockTagToLine.erase(line.tag);
+        trackOwnership(line.tag, false);
     }
 
     line.valid = false;
@@ -154,6 +231,100 @@ void Cache::evictLine(size_t lineIndex, MemoryManager* mem, PCB& process) {
     line.tag = 0;
 }
 
+// Extrai o endereço físico base do bloco a partir da tag (24 bits inferiores; os superiores contêm o PID)
+uint32_t Cache::blockBaseAddress(size_t blockTag) const {
+    size_t blockSizeBytes = wordsPerLine * sizeof(uint32_t);
+    uint32_t blockAddr = blockTag & 0xFFFFFF;
+    return static_cast<uint32_t>(blockAddr * blockSizeBytes);
+}
+
+// Envia uma palavra para a memória: pelo write buffer se habilitado, senão de forma síncrona
+void Cache::enqueueWord(uint32_t address, uint32_t data, MemoryManager* mem, PCB& process) {
+    writeStats.writeThroughWords++;
+
+    if (!writeBuffer.enabled()) {
+        mem->writeToPhysical(address, data, process);
+        return;
+    }
+
+    size_t blockSizeBytes = wordsPerLine * sizeof(uint32_t);
+    uint32_t baseAddress = (address / blockSizeBytes) * blockSizeBytes;
+    size_t wordOffset = (address % blockSizeBytes) / sizeof(uint32_t);
+
+    while (!writeBuffer.pushWord(baseAddress, wordOffset, data, process.pid)) {
+        drainOldest(mem, process, true);
+    }
+}
+
+void Cache::enqueueBlock(uint32_t baseAddress, const std::vector<uint32_t>& block, MemoryManager* mem, PCB& process) {
+    if (!writeBuffer.enabled()) {
+        for (size_t i = 0; i < wordsPerLine; ++i) {
+            uint32_t wordAddress = baseAddress + (i * sizeof(uint32_t));
+            mem->writeToPhysical(wordAddress, block[i], process);
+        }
+        return;
+    }
+
+    while (!writeBuffer.pushBlock(baseAddress, block, process.pid)) {
+        drainOldest(mem, process, true);
+    }
+}
+
+// Drena a entrada mais antiga. Com 'stall' o processo espera pela escrita
+// (buffer cheio) e paga a latência da memória principal; caso contrário a
+// escrita é postada e não atrasa o processo.
+void Cache::drainOldest(MemoryManager* mem, PCB& process, bool stall) {
+    if (writeBuffer.empty()) {
+        return;
+    }
+
+    WriteBufferEntry entry = writeBuffer.popOldest();
+    uint64_t words = 0;
+
+    for (size_t i = 0; i < wordsPerLine; ++i) {
+        if (!entry.validWords[i]) {
+            continue;
+        }
+        uint32_t wordAddress = entry.baseAddress + (i * sizeof(uint32_t));
+        if (stall) {
+            mem->writeToPhysical(wordAddress, entry.data[i], process);
+        } else {
+            mem->postedWriteToPhysical(wordAddress, entry.data[i], &process);
+        }
+        words++;
+    }
+
+    if (stall) {
+        uint64_t cycles = words * process.memWeights.primary;
+        writeStats.stallDrains++;
+        writeStats.stallCycles += cycles;
+        countEvent(process, CounterId::WRITE_BUFFER_STALL_CYCLES, cycles);
+    } else {
+        writeStats.drainedEntries++;
+    }
+}
+
+void Cache::drainBackground(MemoryManager* mem, PCB& process) {
+    if (writeBuffer.enabled() && !writeBuffer.empty()) {
+        drainOldest(mem, process, false);
+    }
+}
+
+// Escreve na memória as entradas do buffer que pertencem ao intervalo físico
+// (usado antes de um frame ser copiado para o swap ou reaproveitado)
+void Cache::flushWriteBufferRange(uint32_t start, size_t size, MemoryManager* mem, PCB* process) {
+    for (auto& entry : writeBuffer.extractRange(start, size)) {
+        for (size_t i = 0; i < wordsPerLine; ++i) {
+            if (!entry.validWords[i]) {
+                continue;
+            }
+            uint32_t wordAddress = entry.baseAddress + (i * sizeof(uint32_t));
+            mem->postedWriteToPhysical(wordAddress, entry.data[i], process);
+        }
+        writeStats.drainedEntries++;
+    }
+}
+
 // Invalida toda a cache
 void Cache::invalidate() {
     std::lock_guard<std::recursive_mutex> lock(cacheMutex);
@@ -167,11 +338,20 @@ void Cache::invalidate() {
     }
 
     blockTagToLine.clear();
+    victimCache.clear();
 
     // Limpa estruturas de política de substituição
-    fifoQueue = std::queue<size_t>();
-    lruOrder.clear();
+    for (auto& queue : fifoQueue) {
+        queue.clear();
+    }
+    for (auto& order : lruOrder) {
+        order.clear();
+    }
     lruPos.clear();
+
+    for (auto& entry : occupancy) {
+        entry.second.lines = 0;
+    }
 }
 
 // Getters para hits e misses
@@ -185,11 +365,19 @@ int Cache::get_hits() {
     return cache_hits;
 }
 
-// Obtém o índice da linha a ser evictada conforme a política atual
-size_t Cache::getLineToEvict() {
+// Obtém o índice da linha a ser evictada no conjunto conforme a política atual,
+// considerando apenas as vias liberadas pela máscara do processo
+size_t Cache::getLineToEvict(size_t setIndex, uint64_t wayMask) {
+    size_t firstLine = setIndex * ways;
+    bool restricted = wayMask != allWaysMask();
 
-    for (size_t i = 0; i < capacity; ++i) {
-        if (!lines[i].valid) {
+    auto allowed = [&](size_t lineIndex) {
+        size_t way = lineIndex - firstLine;
+        return !restricted || (way < 64 && ((wayMask >> way) & 1ULL));
+    };
+
+    for (size_t i = firstLine; i < firstLine + ways; ++i) {
+        if (allowed(i) && !lines[i].valid) {
             return i;
         }
     }
@@ -197,25 +385,29 @@ size_t Cache::getLineToEvict() {
     size_t victimIndex;
 
     if (currentPolicy == PolicyType::FIFO) {
-        // A CachePolicy remove da fila e retorna o índice
-        // victimIndex = policyHandler.getAddressToReplace(fifoQueue);
-        
+        std::deque<size_t>& queue = fifoQueue[setIndex];
+
+        // A linha mais antiga dentre as vias permitidas
+        auto it = std::find_if(queue.begin(), queue.end(), allowed);
+
         // Verificação de segurança (caso a fila estivesse vazia, retornaria max)
-        if (fifoQueue.empty()) {
+        if (it == queue.end()) {
             throw std::runtime_error("Erro: Tentativa de evict em fila FIFO vazia.");
         }
-        victimIndex = fifoQueue.front();
-        fifoQueue.pop();
+        victimIndex = *it;
+        queue.erase(it);
 
     } else { // LRU
-        // A CachePolicy remove do final da lista (back) e retorna o índice
-        // victimIndex = policyHandler.getAddressToReplace(lruOrder);
+        std::list<size_t>& order = lruOrder[setIndex];
+
+        // A linha menos recentemente usada dentre as vias permitidas
+        auto it = std::find_if(order.rbegin(), order.rend(), allowed);
 
-        if (lruOrder.empty()) {
+        if (it == order.rend()) {
              throw std::runtime_error("Erro: Tentativa de evict em lista LRU vazia.");
         }
-        victimIndex = lruOrder.back();
-        lruOrder.pop_back();
+        victimIndex = *it;
+        order.erase(std::next(it).base());
         
         // Removemos do mapa auxiliar de iteradores, pois ele saiu da lista
         lruPos.erase(victimIndex);
@@ -230,14 +422,15 @@ void Cache::updateReplacementPolicy(size_t lineIndex) {
         return;  // FIFO não requer atualização no acesso
     } else if (currentPolicy == PolicyType::LRU) {
         // Se a linha já está na lista, removemos sua posição antiga
+        std::list<size_t>& order = lruOrder[lineIndex / ways];
         auto it = lruPos.find(lineIndex);
         if (it != lruPos.end()) {
-            lruOrder.erase(it->second);
+            order.erase(it->second);
         }
 
         // Adicionamos a linha no início da lista (mais recentemente usada)
-        lruOrder.push_front(lineIndex);
-        lruPos[lineIndex] = lruOrder.begin();
+        order.push_front(lineIndex);
+        lruPos[lineIndex] = order.begin();
     }
 }
 
@@ -257,6 +450,277 @@ PolicyType Cache::getReplacementPolicy() const {
     return currentPolicy;
 }
 
+// Configura política de escrita, write-allocate e tamanho do write buffer (0 desabilita o buffer)
+void Cache::setWritePolicy(WritePolicy policy, bool allocateOnWriteMiss, size_t writeBufferEntries) {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+
+    writePolicy = policy;
+    writeAllocate = allocateOnWriteMiss;
+    writeBuffer = WriteBuffer(writeBufferEntries, wordsPerLine);
+}
+
+WritePolicy Cache::getWritePolicy() const {
+    return writePolicy;
+}
+
+CacheWriteStats Cache::getWriteStats() const {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    CacheWriteStats stats = writeStats;
+    stats.bufferedWrites = writeBuffer.getEnqueuedWrites();
+    stats.coalescedWrites = writeBuffer.getCoalescedWrites();
+    return stats;
+}
+
+// Reorganiza a cache em conjuntos de 'associativity' vias (0 ou >= capacidade
+// equivale a totalmente associativa). Descarta o conteúdo atual.
+void Cache::setOrganization(size_t associativity, size_t victimEntries) {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+
+    if (associativity == 0 || associativity > capacity) {
+        associativity = capacity;
+    }
+    // Mantém todos os conjuntos com o mesmo número de vias
+    while (associativity > 1 && capacity % associativity != 0) {
+        associativity--;
+    }
+
+    ways = std::max<size_t>(1, associativity);
+    numSets = std::max<size_t>(1, capacity / ways);
+
+    fifoQueue.assign(numSets, std::deque<size_t>());
+    lruOrder.assign(numSets, std::list<size_t>());
+    lruPos.clear();
+
+    victimCache = VictimCache(victimEntries);
+
+    setStats.assign(numSets, CacheSetStats());
+    missBreakdown = CacheMissBreakdown();
+    shadowLru.clear();
+    shadowPos.clear();
+    seenBlocks.clear();
+    invalidatedBlocks.clear();
+
+    occupancy.clear();
+    monitors.clear();
+    utilityMasks.clear();
+    accessesSinceRepartition = 0;
+
+    invalidate();
+}
+
+size_t Cache::getAssociativity() const {
+    return ways;
+}
+
+size_t Cache::getNumSets() const {
+    return numSets;
+}
+
+void Cache::setPartitioning(CachePartitionMode mode, uint64_t interval) {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+
+    partitionMode = mode;
+    repartitionInterval = std::max<uint64_t>(1, interval);
+    accessesSinceRepartition = 0;
+    repartitions = 0;
+    monitors.clear();
+    utilityMasks.clear();
+}
+
+CachePartitionMode Cache::getPartitionMode() const {
+    return partitionMode;
+}
+
+uint64_t Cache::allWaysMask() const {
+    return ways >= 64 ? ~0ULL : ((1ULL << ways) - 1);
+}
+
+// Máscara de vias em que o processo pode alocar. Hits continuam valendo em
+// qualquer via; a máscara só restringe a escolha da vítima.
+uint64_t Cache::wayMaskFor(const PCB& process) const {
+    uint64_t all = allWaysMask();
+    uint64_t mask = 0;
+
+    if (partitionMode == CachePartitionMode::STATIC) {
+        mask = process.cacheWayMask;
+    } else if (partitionMode == CachePartitionMode::UTILITY) {
+        auto it = utilityMasks.find(process.pid);
+        if (it != utilityMasks.end()) {
+            mask = it->second;
+        }
+    }
+
+    mask &= all;
+    return mask != 0 ? mask : all;
+}
+
+// Atualiza a ocupação do dono do bloco (PID nos bits superiores da tag)
+void Cache::trackOwnership(size_t blockTag, bool added) {
+    CacheOccupancy& occ = occupancy[static_cast<int>(blockTag >> 24)];
+    if (added) {
+        occ.lines++;
+        occ.peakLines = std::max(occ.peakLines, occ.lines);
+    } else if (occ.lines > 0) {
+        occ.lines--;
+    }
+}
+
+// Monitor de utilidade: pilha LRU de tags por conjunto, independente da
+// partição atual. Um hit na posição d indica que o processo acertaria com
+// d + 1 vias, então wayHits[d] é o ganho marginal da (d + 1)-ésima via.
+void Cache::updateUtilityMonitor(const AddressDecoded& info, int pid) {
+    UtilityMonitor& monitor = monitors[pid];
+    if (monitor.sets.size() != numSets) {
+        monitor.sets.assign(numSets, std::list<size_t>());
+        monitor.wayHits.assign(ways, 0);
+    }
+    monitor.intervalAccesses++;
+
+    std::list<size_t>& stack = monitor.sets[info.setIndex];
+    size_t depth = 0;
+    for (auto it = stack.begin(); it != stack.end(); ++it, ++depth) {
+        if (*it == info.tag) {
+            monitor.wayHits[depth]++;
+            stack.erase(it);
+            break;
+        }
+    }
+
+    stack.push_front(info.tag);
+    if (stack.size() > ways) {
+        stack.pop_back();
+    }
+}
+
+// Reparticionamento por utilidade: cada processo ativo no intervalo recebe uma
+// via e as restantes vão, uma a uma, para quem ganharia mais hits com ela.
+// Processos sem medição (novos ou inativos) compartilham todas as vias.
+void Cache::repartition() {
+    accessesSinceRepartition = 0;
+    repartitions++;
+
+    std::vector<int> active;
+    for (const auto& [pid, monitor] : monitors) {
+        if (monitor.intervalAccesses > 0) {
+            active.push_back(pid);
+        }
+    }
+    std::sort(active.begin(), active.end());
+
+    utilityMasks.clear();
+    if (!active.empty() && active.size() <= ways && ways <= 64) {
+        std::unordered_map<int, size_t> alloc;
+        for (int pid : active) {
+            alloc[pid] = 1;
+        }
+
+        for (size_t spare = ways - active.size(); spare > 0; --spare) {
+            int best = active.front();
+            uint64_t bestGain = 0;
+            bool found = false;
+            for (int pid : active) {
+                uint64_t gain = monitors[pid].wayHits[alloc[pid]];
+                if (!found || gain > bestGain) {
+                    best = pid;
+                    bestGain = gain;
+                    found = true;
+                }
+            }
+            alloc[best]++;
+        }
+
+        // Vias contíguas por processo, na ordem dos PIDs
+        size_t offset = 0;
+        for (int pid : active) {
+            size_t count = alloc[pid];
+            uint64_t bits = count >= 64 ? ~0ULL : ((1ULL << count) - 1);
+            utilityMasks[pid] = bits << offset;
+            offset += count;
+        }
+    }
+
+    // Envelhece os contadores para acompanhar mudanças de fase
+    for (auto& [pid, monitor] : monitors) {
+        for (auto& hits : monitor.wayHits) {
+            hits /= 2;
+        }
+        monitor.intervalAccesses = 0;
+    }
+}
+
+// Atualiza o histograma do conjunto e classifica o miss (compulsório,
+// capacidade ou conflito) usando uma cache sombra totalmente associativa LRU
+// com a mesma capacidade.
+void Cache::recordAccess(const AddressDecoded& info, bool hit, int pid) {
+    CacheSetStats& stats = setStats[info.setIndex];
+    stats.accesses++;
+
+    CacheOccupancy& occ = occupancy[pid];
+    occ.accesses++;
+    occ.lineSamples += occ.lines;
+    if (!hit) {
+        occ.misses++;
+    }
+
+    if (partitionMode == CachePartitionMode::UTILITY) {
+        updateUtilityMonitor(info, pid);
+        if (++accessesSinceRepartition >= repartitionInterval) {
+            repartition();
+        }
+    }
+
+    auto shadowIt = shadowPos.find(info.tag);
+    bool shadowHit = shadowIt != shadowPos.end();
+
+    if (!hit) {
+        stats.misses++;
+        if (seenBlocks.insert(info.tag).second) {
+            missBreakdown.compulsory++;
+        } else if (invalidatedBlocks.erase(info.tag) > 0) {
+            missBreakdown.invalidation++;
+        } else if (shadowHit) {
+            missBreakdown.conflict++;
+            stats.conflictMisses++;
+        } else {
+            missBreakdown.capacity++;
+        }
+    }
+
+    if (shadowHit) {
+        shadowLru.erase(shadowIt->second);
+    } else if (shadowLru.size() >= capacity) {
+        shadowPos.erase(shadowLru.back());
+        shadowLru.pop_back();
+    }
+    shadowLru.push_front(info.tag);
+    shadowPos[info.tag] = shadowLru.begin();
+}
+
+std::vector<CacheSetStats> Cache::getSetStats() const {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    return setStats;
+}
+
+CacheMissBreakdown Cache::getMissBreakdown() const {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    return missBreakdown;
+}
+
+uint64_t Cache::getVictimHits() const {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    return victimCache.getHits();
+}
+
+std::map<int, CacheOccupancy> Cache::getOccupancy() const {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    return std::map<int, CacheOccupancy>(occupancy.begin(), occupancy.end());
+}
+
+uint64_t Cache::getRepartitions() const {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex);
+    return repartitions;
+}
+
 size_t Cache::getUsage() const {
     std::lock_guard<std::recursive_mutex> lock(cacheMutex);
     size_t used = 0;
@@ -287,18 +751,35 @@ void Cache::invalidatePage(uint32_t physicalAddressStart, size_t size, int pid,
             
             // Write back if dirty
             if (lines[lineIndex].dirty && lines[lineIndex].valid && process != nullptr) {
-                evictLine(lineIndex, mem, *process);
                 // evictLine invalidates the line and removes from map.
-                continue;
+                evictLine(lineIndex, mem, *process, false);
+            } else {
+                // Invalidate line
+                trackOwnership(lines[lineIndex].tag, false);
+                lines[lineIndex].valid = false;
+                lines[lineIndex].dirty = false;
+                lines[lineIndex].tag = 0;
+
+                // Remove from map
+                blockTagToLine.erase(it);
             }
+        }
 
-            // Invalidate line (evictLine might have already done this, but let's be sure)
-            lines[lineIndex].valid = false;
-            lines[lineIndex].dirty = false;
-            lines[lineIndex].tag = 0;
-            
-            // Remove from map
-            blockTagToLine.erase(it);
+        // O próximo miss deste bloco é causado pelo swap, não por conflito
+        auto shadowIt = shadowPos.find(info.tag);
+        if (shadowIt != shadowPos.end()) {
+            shadowLru.erase(shadowIt->second);
+            shadowPos.erase(shadowIt);
+            invalidatedBlocks.insert(info.tag);
+        }
+
+        // O bloco também pode estar na victim cache
+        VictimEntry stale;
+        if (victimCache.extract(info.tag, stale) && stale.dirty && process != nullptr) {
+            enqueueBlock(blockBaseAddress(stale.tag), stale.data, mem, *process);
         }
     }
+
+    // Write-backs pendentes desse frame precisam chegar à RAM antes do frame ser reutilizado
+    flushWriteBufferRange(physicalAddressStart, size, mem, process);
 }
@@ -1,18 +1,25 @@
 #ifndef CACHE_HPP
 #define CACHE_HPP
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <list>
+#include <map>
 #include <mutex>
+#include <deque>
 #include <queue>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "../MemoryManager.hpp"
 #include "../../memory/replacementPolicy.hpp"
 #include "../PCB.hpp"
+#include "writeBuffer.hpp"
+#include "victimCache.hpp"
+#include "cacheStats.hpp"
 
 // Forward declarations para evitar ciclo de includes
 class MemoryManager;
@@ -20,6 +27,7 @@ class PCB;
 
 struct AddressDecoded {
     size_t tag;         // Qual bloco é? (inclui PID para isolamento)
+    size_t setIndex;    // Em qual conjunto o bloco pode ser alocado?
     size_t wordOffset;  // Qual palavra dentro do bloco?
 };
 
@@ -44,17 +52,52 @@ class Cache {
     // numero de palavras por linha
     const size_t wordsPerLine;
 
+    // Organização em conjuntos: o conjunto s ocupa as linhas [s * ways, (s + 1) * ways)
+    size_t ways;
+    size_t numSets;
+
     // Mapeamento: tag do bloco -> índice da linha na cache
     std::unordered_map<size_t, size_t> blockTagToLine;
 
-    // Políticas de substituição
-    std::queue<size_t> fifoQueue;  // Para FIFO
-    std::list<size_t> lruOrder;    // Para LRU
+    // Políticas de substituição (uma fila/lista por conjunto)
+    std::vector<std::deque<size_t>> fifoQueue;  // Para FIFO
+    std::vector<std::list<size_t>> lruOrder;    // Para LRU
     std::unordered_map<size_t, std::list<size_t>::iterator> lruPos;
 
+    // Victim cache entre a L1 e a memória principal
+    VictimCache victimCache;
+
+    // Instrumentação por conjunto e classificação dos misses
+    std::vector<CacheSetStats> setStats;
+    CacheMissBreakdown missBreakdown;
+    std::list<size_t> shadowLru;  // Cache sombra totalmente associativa (apenas tags)
+    std::unordered_map<size_t, std::list<size_t>::iterator> shadowPos;
+    std::unordered_set<size_t> seenBlocks;
+    std::unordered_set<size_t> invalidatedBlocks;
+
+    // Particionamento de vias por processo
+    struct UtilityMonitor {
+        std::vector<std::list<size_t>> sets;  // Pilha LRU de tags por conjunto (profundidade = ways)
+        std::vector<uint64_t> wayHits;        // Hits por posição da pilha: ganho de cada via extra
+        uint64_t intervalAccesses = 0;
+    };
+    CachePartitionMode partitionMode;
+    uint64_t repartitionInterval;
+    uint64_t accessesSinceRepartition;
+    uint64_t repartitions;
+    std::unordered_map<int, uint64_t> utilityMasks;
+    std::unordered_map<int, UtilityMonitor> monitors;
+    std::unordered_map<int, CacheOccupancy> occupancy;
+
     PolicyType currentPolicy;
     ReplacementPolicy policyHandler;
 
+    // Política de escrita e buffer de escrita
+    WritePolicy writePolicy;
+    bool writeAllocate;
+    WriteBuffer writeBuffer;
+    CacheWriteStats writeStats;
+
     AddressDecoded decodeAddress(uint32_t address, int pid) const;
 
     int cache_hits;
@@ -62,10 +105,28 @@ class Cache {
 
     mutable std::recursive_mutex cacheMutex;
 
-    size_t getLineToEvict();
+    size_t getLineToEvict(size_t setIndex, uint64_t wayMask);
     void updateReplacementPolicy(size_t lineIndex);
+    size_t allocateLine(const AddressDecoded& info, MemoryManager* mem, PCB& process);
     void loadBlock(size_t blockTag, size_t lineIndex, MemoryManager* mem, PCB& process);
-    void evictLine(size_t lineIndex, MemoryManager* mem, PCB& process);
+    void installBlock(size_t blockTag, size_t lineIndex, const std::vector<uint32_t>& data, bool dirty);
+    void evictLine(size_t lineIndex, MemoryManager* mem, PCB& process, bool toVictimCache = false);
+    void recordAccess(const AddressDecoded& info, bool hit, int pid);
+    uint32_t blockBaseAddress(size_t blockTag) const;
+
+    // Particionamento e ocupação
+    uint64_t allWaysMask() const;
+    uint64_t wayMaskFor(const PCB& process) const;
+    void trackOwnership(size_t blockTag, bool added);
+    void updateUtilityMonitor(const AddressDecoded& info, int pid);
+    void repartition();
+
+    // Envio de escritas para a memória (direto ou via write buffer)
+    void enqueueWord(uint32_t address, uint32_t data, MemoryManager* mem, PCB& process);
+    void enqueueBlock(uint32_t baseAddress, const std::vector<uint32_t>& block, MemoryManager* mem, PCB& process);
+    void drainOldest(MemoryManager* mem, PCB& process, bool stall);
+    void drainBackground(MemoryManager* mem, PCB& process);
+    void flushWriteBufferRange(uint32_t start, size_t size, MemoryManager* mem, PCB* process);
 
    public:
     Cache(size_t numLines, size_t wordsPerLine, PolicyType policy);
@@ -81,6 +142,15 @@ class Cache {
     // Configuração
     void setReplacementPolicy(PolicyType policy);
     PolicyType getReplacementPolicy() const;
+    void setWritePolicy(WritePolicy policy, bool allocateOnWriteMiss, size_t writeBufferEntries);
+    WritePolicy getWritePolicy() const;
+    // Associatividade (0 = totalmente associativa) e entradas da victim cache (0 = desabilitada)
+    void setOrganization(size_t associativity, size_t victimEntries);
+    size_t getAssociativity() const;
+    size_t getNumSets() const;
+    // Particionamento de vias; 'interval' = acessos entre reparticionamentos (modo UTILITY)
+    void setPartitioning(CachePartitionMode mode, uint64_t interval);
+    CachePartitionMode getPartitionMode() const;
 
     // Utilidades
     void invalidate();
@@ -89,6 +159,12 @@ class Cache {
     // Métricas de uso
     size_t getUsage() const;
     size_t getCapacity() const;
+    CacheWriteStats getWriteStats() const;
+    std::vector<CacheSetStats> getSetStats() const;
+    CacheMissBreakdown getMissBreakdown() const;
+    uint64_t getVictimHits() const;
+    std::map<int, CacheOccupancy> getOccupancy() const;
+    uint64_t getRepartitions() const;
 };
 
 #endif
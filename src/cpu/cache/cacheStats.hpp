@@ -0,0 +1,40 @@
+#ifndef CACHE_STATS_HPP
+#define CACHE_STATS_HPP
+
+#include <cstdint>
+
+// Contadores por conjunto (histograma de conflitos)
+struct CacheSetStats {
+    uint64_t accesses = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;       // Linhas válidas expulsas por um miss
+    uint64_t conflictMisses = 0;  // Misses que uma cache totalmente associativa teria evitado
+    uint64_t victimHits = 0;      // Misses atendidos pela victim cache
+};
+
+// Classificação dos misses (modelo dos 3 Cs)
+struct CacheMissBreakdown {
+    uint64_t compulsory = 0;  // Primeira referência ao bloco
+    uint64_t capacity = 0;    // Também falharia numa cache totalmente associativa de mesmo tamanho
+    uint64_t conflict = 0;    // Causado pelo mapeamento em conjuntos
+    uint64_t invalidation = 0; // Bloco removido por swap-out da página (invalidatePage)
+};
+
+// Particionamento de vias entre processos (QoS da cache)
+enum class CachePartitionMode {
+    NONE,     // Qualquer processo pode ocupar qualquer via
+    STATIC,   // Máscara fixa por PID/prioridade (PCB::cacheWayMask)
+    UTILITY   // Máscaras recalculadas periodicamente pela utilidade marginal de cada via
+};
+
+// Ocupação da cache por processo
+struct CacheOccupancy {
+    uint64_t lines = 0;        // Linhas válidas do processo no momento
+    uint64_t peakLines = 0;    // Maior ocupação observada
+    uint64_t lineSamples = 0;  // Soma da ocupação amostrada a cada acesso (média = lineSamples / accesses)
+    uint64_t accesses = 0;
+    uint64_t misses = 0;
+    uint64_t wayMask = 0;      // Máscara de vias usada na última alocação
+};
+
+#endif
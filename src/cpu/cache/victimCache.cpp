@@ -0,0 +1,76 @@
+#include "victimCache.hpp"
+
+VictimCache::VictimCache(size_t capacity)
+    : capacity(capacity),
+      hits(0),
+      probes(0),
+      insertions(0) {}
+
+bool VictimCache::enabled() const {
+    return capacity > 0;
+}
+
+size_t VictimCache::size() const {
+    return entries.size();
+}
+
+size_t VictimCache::getCapacity() const {
+    return capacity;
+}
+
+bool VictimCache::take(size_t tag, VictimEntry& out) {
+    if (!enabled()) {
+        return false;
+    }
+
+    probes++;
+    if (!extract(tag, out)) {
+        return false;
+    }
+    hits++;
+    return true;
+}
+
+bool VictimCache::extract(size_t tag, VictimEntry& out) {
+    auto it = index.find(tag);
+    if (it == index.end()) {
+        return false;
+    }
+
+    out = std::move(*it->second);
+    entries.erase(it->second);
+    index.erase(it);
+    return true;
+}
+
+bool VictimCache::insert(VictimEntry entry, VictimEntry& displaced) {
+    if (!enabled()) {
+        displaced = std::move(entry);
+        return true;
+    }
+
+    bool hasDisplaced = false;
+
+    // Bloco repetido: substitui a cópia antiga
+    auto existing = index.find(entry.tag);
+    if (existing != index.end()) {
+        entries.erase(existing->second);
+        index.erase(existing);
+    } else if (entries.size() >= capacity) {
+        displaced = std::move(entries.back());
+        index.erase(displaced.tag);
+        entries.pop_back();
+        hasDisplaced = true;
+    }
+
+    entries.push_front(std::move(entry));
+    index[entries.front().tag] = entries.begin();
+    insertions++;
+
+    return hasDisplaced;
+}
+
+void VictimCache::clear() {
+    entries.clear();
+    index.clear();
+}
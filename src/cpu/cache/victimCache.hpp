@@ -0,0 +1,57 @@
+#ifndef VICTIM_CACHE_HPP
+#define VICTIM_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/*
+  Victim cache: pequena cache totalmente associativa (LRU) que guarda as linhas
+  expulsas da L1. Um miss na L1 que encontra o bloco aqui troca a linha de volta
+  sem acessar a memória principal, o que elimina boa parte dos misses de
+  conflito de uma cache com baixa associatividade.
+*/
+
+struct VictimEntry {
+    size_t tag = 0;              // Mesma tag da L1 (inclui PID)
+    std::vector<uint32_t> data;  // Dados do bloco
+    bool dirty = false;          // Precisa de write-back ao sair da victim cache
+};
+
+class VictimCache {
+   private:
+    std::list<VictimEntry> entries;  // front = mais recentemente inserido
+    std::unordered_map<size_t, std::list<VictimEntry>::iterator> index;
+    size_t capacity;
+
+    uint64_t hits;
+    uint64_t probes;
+    uint64_t insertions;
+
+   public:
+    explicit VictimCache(size_t capacity = 0);
+
+    bool enabled() const;
+    size_t size() const;
+    size_t getCapacity() const;
+
+    // Procura o bloco; em caso de hit remove-o da victim cache e devolve em 'out'
+    bool take(size_t tag, VictimEntry& out);
+
+    // Remove o bloco sem contabilizar como consulta (invalidação de página)
+    bool extract(size_t tag, VictimEntry& out);
+
+    // Insere um bloco expulso da L1. Se a victim cache estiver cheia, a entrada
+    // mais antiga é removida e devolvida em 'displaced' (retorno true).
+    bool insert(VictimEntry entry, VictimEntry& displaced);
+
+    void clear();
+
+    uint64_t getHits() const { return hits; }
+    uint64_t getProbes() const { return probes; }
+    uint64_t getInsertions() const { return insertions; }
+};
+
+#endif
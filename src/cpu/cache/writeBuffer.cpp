@@ -0,0 +1,150 @@
+#include "writeBuffer.hpp"
+
+#include <stdexcept>
+
+size_t WriteBufferEntry::pendingWords() const {
+    size_t count = 0;
+    for (bool v : validWords) {
+        if (v) count++;
+    }
+    return count;
+}
+
+WriteBuffer::WriteBuffer(size_t capacity, size_t wordsPerBlock)
+    : capacity(capacity),
+      wordsPerBlock(wordsPerBlock),
+      coalescedWrites(0),
+      enqueuedWrites(0) {}
+
+bool WriteBuffer::enabled() const {
+    return capacity > 0;
+}
+
+bool WriteBuffer::full() const {
+    return entries.size() >= capacity;
+}
+
+bool WriteBuffer::empty() const {
+    return entries.empty();
+}
+
+size_t WriteBuffer::size() const {
+    return entries.size();
+}
+
+size_t WriteBuffer::getCapacity() const {
+    return capacity;
+}
+
+WriteBufferEntry* WriteBuffer::findEntry(uint32_t baseAddress) {
+    for (auto& entry : entries) {
+        if (entry.baseAddress == baseAddress) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool WriteBuffer::pushWord(uint32_t baseAddress, size_t wordOffset, uint32_t value, int pid) {
+    if (wordOffset >= wordsPerBlock) {
+        throw std::out_of_range("WriteBuffer: offset de palavra fora do bloco");
+    }
+
+    // Coalescência: o bloco já está no buffer, apenas atualiza a palavra
+    if (WriteBufferEntry* entry = findEntry(baseAddress)) {
+        entry->data[wordOffset] = value;
+        entry->validWords[wordOffset] = true;
+        coalescedWrites++;
+        return true;
+    }
+
+    if (full()) {
+        return false;
+    }
+
+    WriteBufferEntry entry(wordsPerBlock);
+    entry.baseAddress = baseAddress;
+    entry.ownerPID = pid;
+    entry.data[wordOffset] = value;
+    entry.validWords[wordOffset] = true;
+    entries.push_back(std::move(entry));
+    enqueuedWrites++;
+    return true;
+}
+
+bool WriteBuffer::pushBlock(uint32_t baseAddress, const std::vector<uint32_t>& block, int pid) {
+    if (WriteBufferEntry* entry = findEntry(baseAddress)) {
+        for (size_t i = 0; i < wordsPerBlock && i < block.size(); ++i) {
+            entry->data[i] = block[i];
+            entry->validWords[i] = true;
+        }
+        coalescedWrites++;
+        return true;
+    }
+
+    if (full()) {
+        return false;
+    }
+
+    WriteBufferEntry entry(wordsPerBlock);
+    entry.baseAddress = baseAddress;
+    entry.ownerPID = pid;
+    for (size_t i = 0; i < wordsPerBlock && i < block.size(); ++i) {
+        entry.data[i] = block[i];
+        entry.validWords[i] = true;
+    }
+    entries.push_back(std::move(entry));
+    enqueuedWrites++;
+    return true;
+}
+
+WriteBufferEntry WriteBuffer::popOldest() {
+    if (entries.empty()) {
+        throw std::runtime_error("WriteBuffer: tentativa de drenar buffer vazio");
+    }
+    WriteBufferEntry entry = std::move(entries.front());
+    entries.pop_front();
+    return entry;
+}
+
+std::vector<WriteBufferEntry> WriteBuffer::extractRange(uint32_t start, size_t size) {
+    std::vector<WriteBufferEntry> extracted;
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->baseAddress >= start && it->baseAddress < start + size) {
+            extracted.push_back(std::move(*it));
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return extracted;
+}
+
+void WriteBuffer::forward(uint32_t baseAddress, std::vector<uint32_t>& block) const {
+    for (const auto& entry : entries) {
+        if (entry.baseAddress != baseAddress) {
+            continue;
+        }
+        for (size_t i = 0; i < wordsPerBlock && i < block.size(); ++i) {
+            if (entry.validWords[i]) {
+                block[i] = entry.data[i];
+            }
+        }
+        return;
+    }
+}
+
+bool WriteBuffer::forwardWord(uint32_t baseAddress, size_t wordOffset, uint32_t& value) const {
+    for (const auto& entry : entries) {
+        if (entry.baseAddress == baseAddress && wordOffset < wordsPerBlock &&
+            entry.validWords[wordOffset]) {
+            value = entry.data[wordOffset];
+            return true;
+        }
+    }
+    return false;
+}
+
+void WriteBuffer::clear() {
+    entries.clear();
+}
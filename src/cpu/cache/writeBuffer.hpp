@@ -0,0 +1,91 @@
+#ifndef WRITE_BUFFER_HPP
+#define WRITE_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Política de escrita da cache
+enum class WritePolicy {
+    WRITE_BACK,     // Escreve apenas na linha; memória atualizada na evicção
+    WRITE_THROUGH   // Toda escrita também é enviada à memória (via write buffer)
+};
+
+// Contadores de tráfego de escrita da cache
+struct CacheWriteStats {
+    uint64_t writebackBlocks = 0;    // Linhas sujas enviadas à memória
+    uint64_t writeThroughWords = 0;  // Palavras propagadas por write-through / no-write-allocate
+    uint64_t bufferedWrites = 0;     // Entradas novas no write buffer
+    uint64_t coalescedWrites = 0;    // Escritas mescladas em entradas existentes
+    uint64_t drainedEntries = 0;     // Entradas drenadas em segundo plano
+    uint64_t stallDrains = 0;        // Drenagens forçadas por buffer cheio
+    uint64_t stallCycles = 0;        // Ciclos de stall causados por buffer cheio
+};
+
+/*
+  Buffer de escrita com coalescência entre a cache L1 e a memória principal.
+  Cada entrada representa um bloco físico (endereço base alinhado ao tamanho da
+  linha) e guarda apenas as palavras escritas (máscara de válidos). Escritas no
+  mesmo bloco são mescladas na entrada existente em vez de ocupar uma nova.
+  As entradas são drenadas em ordem FIFO pela cache quando o barramento está
+  livre, ou de forma síncrona (stall) quando o buffer está cheio.
+*/
+
+struct WriteBufferEntry {
+    uint32_t baseAddress = 0;        // Endereço físico do início do bloco
+    int ownerPID = -1;               // Processo que gerou a escrita
+    std::vector<uint32_t> data;      // Palavras do bloco
+    std::vector<bool> validWords;    // Quais palavras possuem dado pendente
+
+    WriteBufferEntry(size_t wordsPerBlock = 0)
+        : data(wordsPerBlock, 0), validWords(wordsPerBlock, false) {}
+
+    size_t pendingWords() const;
+};
+
+class WriteBuffer {
+   private:
+    std::deque<WriteBufferEntry> entries;
+    size_t capacity;
+    size_t wordsPerBlock;
+
+    // Estatísticas
+    uint64_t coalescedWrites;
+    uint64_t enqueuedWrites;
+
+    WriteBufferEntry* findEntry(uint32_t baseAddress);
+
+   public:
+    WriteBuffer(size_t capacity, size_t wordsPerBlock);
+
+    bool enabled() const;
+    bool full() const;
+    bool empty() const;
+    size_t size() const;
+    size_t getCapacity() const;
+
+    // Tenta mesclar/enfileirar uma palavra. Retorna false se o buffer estiver
+    // cheio e a escrita não puder ser coalescida (o chamador deve drenar antes).
+    bool pushWord(uint32_t baseAddress, size_t wordOffset, uint32_t value, int pid);
+
+    // Enfileira um bloco inteiro (write-back de linha suja).
+    bool pushBlock(uint32_t baseAddress, const std::vector<uint32_t>& block, int pid);
+
+    // Remove e devolve a entrada mais antiga
+    WriteBufferEntry popOldest();
+
+    // Remove e devolve as entradas cujo bloco cai em [start, start + size)
+    std::vector<WriteBufferEntry> extractRange(uint32_t start, size_t size);
+
+    // Encaminha palavras pendentes do bloco para 'block' (leitura após escrita)
+    void forward(uint32_t baseAddress, std::vector<uint32_t>& block) const;
+    bool forwardWord(uint32_t baseAddress, size_t wordOffset, uint32_t& value) const;
+
+    void clear();
+
+    uint64_t getCoalescedWrites() const { return coalescedWrites; }
+    uint64_t getEnqueuedWrites() const { return enqueuedWrites; }
+};
+
+#endif
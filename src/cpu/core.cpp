@@ -1,5 +1,7 @@
 #include "core.hpp"
 
+#include <algorithm>
+
 #include "CONTROL_UNIT.hpp"
 
 namespace {
@@ -41,24 +43,30 @@ void CPUCore::stop() {
     running.store(false);
 }
 
-void CPUCore::submitProcess(PCB *process, bool printLockState) {
+void CPUCore::enqueue(PCB *process) {
     if (process == nullptr) {
         return;
     }
 
-    std::unique_lock<std::mutex> lock(workMutex);
-    workCv.wait(lock, [&]() {
-        return stopRequested.load() || currentProcess == nullptr;
-    });
+    runQueue.push(process);
+    wake();
 
-    if (stopRequested.load()) {
-        return;
+    // Dono ocupado: acorda um vizinho ocioso para que ele possa roubar o processo
+    if (!isIdle()) {
+        for (CPUCore *peer : peers) {
+            if (peer->isIdle()) {
+                peer->wake();
+                break;
+            }
+        }
     }
+}
 
-    currentProcess = process;
-    currentPrintLock = printLockState;
-    ioRequestsBuffer.clear();
-    lock.unlock();
+void CPUCore::wake() {
+    {
+        std::lock_guard<std::mutex> lock(workMutex);
+        wakePending = true;
+    }
     workCv.notify_one();
 }
 
@@ -71,49 +79,174 @@ std::size_t CPUCore::id() const {
     return coreId;
 }
 
+std::size_t CPUCore::queuedProcesses() const {
+    return runQueue.size();
+}
+
+std::size_t CPUCore::load() const {
+    return runQueue.size() + (isIdle() ? 0 : 1);
+}
+
+PCB *CPUCore::nextProcess() {
+    if (held.load()) {
+        return nullptr;
+    }
+    if (PCB *local = runQueue.take()) {
+        return local;
+    }
+    return stealFromPeers();
+}
+
+// Percorre os vizinhos a partir do próximo núcleo e rouba o processo que o
+// vizinho executaria por último
+PCB *CPUCore::stealFromPeers() {
+    if (peers.empty()) {
+        return nullptr;
+    }
+
+    stealAttempts.fetch_add(1, std::memory_order_relaxed);
+    for (CPUCore *peer : peers) {
+        if (PCB *victim = peer->runQueue.steal()) {
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return victim;
+        }
+    }
+    return nullptr;
+}
+
+// A fatia começa quando o núcleo está livre e o processo já está pronto na
+// linha do tempo (chegada, fim da fatia anterior, fim de I/O ou liberação do job)
+uint64_t CPUCore::beginSlice(PCB &process) {
+    uint64_t start = std::max(clock.load(), process.readyAt);
+    if (process.coresAssigned.empty()) {
+        process.startTime.store(start);
+    }
+    {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        dispatchWait.sample(start - process.readyAt);
+    }
+
+    if (process.isPeriodic()) {
+        RealtimeState &rt = *process.rt;
+        uint64_t remaining = rt.rtWcet > rt.jobCycles ? rt.rtWcet - rt.jobCycles : 0;
+        int64_t laxity = static_cast<int64_t>(rt.absoluteDeadline) -
+                         static_cast<int64_t>(start + remaining);
+        rt.minLaxity = std::min(rt.minLaxity, laxity);
+        rt.laxitySum += laxity;
+        rt.laxitySamples++;
+    }
+    return start;
+}
+
 void CPUCore::workerLoop() {
     while (true) {
-        PCB *process = nullptr;
-        bool printLockState = true;
-        {
+        PCB *process = nextProcess();
+
+        if (!process) {
             std::unique_lock<std::mutex> lock(workMutex);
             workCv.wait(lock, [&]() {
-                return stopRequested.load() || currentProcess != nullptr;
+                return stopRequested.load() || wakePending;
             });
+            wakePending = false;
 
-            if (stopRequested.load() && currentProcess == nullptr) {
+            if (stopRequested.load() && runQueue.empty()) {
                 break;
             }
+            continue;
+        }
 
-            process = currentProcess;
-            printLockState = currentPrintLock;
+        {
+            std::lock_guard<std::mutex> lock(workMutex);
+            currentProcess = process;
         }
 
-        if (!process) {
-            continue;
+        // A cache do núcleo anterior não serve aqui: o processo paga o aquecimento
+        uint64_t penalty = 0;
+        if (!process->coresAssigned.empty() &&
+            process->coresAssigned.back() != static_cast<int>(coreId)) {
+            penalty = migrationPenalty;
+            migrations.fetch_add(1, std::memory_order_relaxed);
+            migrationCycles.fetch_add(penalty, std::memory_order_relaxed);
+            process->migrations.fetch_add(1);
+            process->migration_cycles.fetch_add(penalty);
         }
 
+        uint64_t sliceStart = beginSlice(*process);
+        process->coresAssigned.push_back(static_cast<int>(coreId));
+        process->state.store(State::Running);
+        int cyclesBefore = process->timeStamp;
+        uint64_t memoryBefore = process->memory_cycles.load();
+
         ioRequestsBuffer.clear();
-        std::atomic<bool> printLock(printLockState);
-        Core(memManager, *process, &ioRequestsBuffer, printLock, schedulingAlgorithm);
+        std::atomic<bool> printLock(false);
+        Core(memManager, *process, &ioRequestsBuffer, printLock, schedulingAlgorithm, serialPipeline);
+        slices.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t cost = penalty + static_cast<uint64_t>(std::max(0, process->timeStamp - cyclesBefore)) +
+                        (process->memory_cycles.load() - memoryBefore);
+        process->lastRunEnd = sliceStart + cost;
+        if (process->rt) {
+            process->rt->jobCycles += cost;
+        }
+        process->serviceCycles.fetch_add(cost);
+        clock.store(process->lastRunEnd);
 
         {
             std::lock_guard<std::mutex> lock(workMutex);
             currentProcess = nullptr;
-            currentPrintLock = true;
         }
-        workCv.notify_all();
-    }
-}
 
-void CPUCore::resetCurrentProcess() {
-    std::lock_guard<std::mutex> lock(workMutex);
-    currentProcess = nullptr;
-    currentPrintLock = true;
-    ioRequestsBuffer.clear();
-    workCv.notify_all();
+        if (onCompletion) {
+            onCompletion(coreId, process);
+        }
+    }
 }
 
 void CPUCore::setSchedulingAlgorithm(int algorithm) {
     schedulingAlgorithm = algorithm;
-}
\ No newline at end of file
+}
+
+void CPUCore::setReadyQueue(std::unique_ptr<ReadyQueue> ready) {
+    runQueue.setPolicy(std::move(ready));
+}
+
+void CPUCore::setMigrationPenalty(uint64_t cycles) {
+    migrationPenalty = cycles;
+}
+
+void CPUCore::setSerialPipeline(bool enabled) {
+    serialPipeline = enabled;
+}
+
+void CPUCore::setPeers(const std::vector<CPUCore *> &peers) {
+    this->peers = peers;
+}
+
+void CPUCore::hold() {
+    held.store(true);
+}
+
+void CPUCore::release() {
+    held.store(false);
+    wake();
+}
+
+void CPUCore::setCompletionCallback(CompletionCallback callback) {
+    onCompletion = std::move(callback);
+}
+
+StatHistogram CPUCore::getDispatchWait() const {
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    return dispatchWait;
+}
+
+CoreQueueStats CPUCore::getQueueStats() const {
+    CoreQueueStats stats;
+    stats.slices = slices.load();
+    stats.steals = steals.load();
+    stats.stealAttempts = stealAttempts.load();
+    stats.migrations = migrations.load();
+    stats.clock = clock.load();
+    stats.migrationCycles = migrationCycles.load();
+    return stats;
+}
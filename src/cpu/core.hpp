@@ -3,6 +3,8 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -10,8 +12,19 @@
 
 #include "MemoryManager.hpp"
 #include "PCB.hpp"
+#include "runQueue.hpp"
 #include "../IO/IOManager.hpp"
 
+// Contadores de balanceamento de um núcleo
+struct CoreQueueStats {
+    uint64_t slices = 0;         // Fatias de execução concluídas
+    uint64_t steals = 0;         // Processos roubados de outros núcleos
+    uint64_t stealAttempts = 0;  // Varreduras dos vizinhos com a fila local vazia
+    uint64_t migrations = 0;     // Fatias executadas fora do último núcleo do processo
+    uint64_t clock = 0;          // Relógio simulado do núcleo (ciclos)
+    uint64_t migrationCycles = 0; // Penalidade de migração cobrada neste núcleo
+};
+
 class CPUCore {
 public:
     CPUCore(std::size_t coreId,
@@ -25,16 +38,44 @@ public:
     void start();
     void stop();
 
-    void submitProcess(PCB *process, bool printLockState = true);
+    // Coloca o processo na fila local deste núcleo
+    void enqueue(PCB *process);
 
     bool isIdle() const;
     std::size_t id() const;
+    std::size_t queuedProcesses() const;
+    // Processos na fila mais o que está executando
+    std::size_t load() const;
 
     void setSchedulingAlgorithm(int algorithm);
+    void setReadyQueue(std::unique_ptr<ReadyQueue> ready);
+    // Custo, em ciclos, de aquecer a cache ao receber um processo de outro núcleo
+    void setMigrationPenalty(uint64_t cycles);
+    // Pipeline serial, uma instrução por vez (simulation.deterministic)
+    void setSerialPipeline(bool enabled);
+
+    // Núcleos dos quais este pode roubar quando a fila local esvaziar
+    void setPeers(const std::vector<CPUCore *> &peers);
+
+    // Janelas conservadoras: com o núcleo retido, os processos enfileirados
+    // só começam quando o despachante abre a janela (release)
+    void hold();
+    void release();
+
+    // Chamado pela thread do núcleo ao terminar cada fatia de execução
+    using CompletionCallback = std::function<void(std::size_t, PCB *)>;
+    void setCompletionCallback(CompletionCallback callback);
+
+    CoreQueueStats getQueueStats() const;
+    // Ciclos que cada fatia esperou entre ficar pronta e começar neste núcleo
+    StatHistogram getDispatchWait() const;
 
 private:
     void workerLoop();
-    void resetCurrentProcess();
+    void wake();
+    PCB *nextProcess();
+    PCB *stealFromPeers();
+    uint64_t beginSlice(PCB &process);
 
     const std::size_t coreId;
     MemoryManager &memManager;
@@ -47,9 +88,28 @@ private:
     mutable std::mutex workMutex;
     std::condition_variable workCv;
     PCB *currentProcess{nullptr};
-    bool currentPrintLock{true};
+    bool wakePending{false};
+    std::atomic<bool> held{false};
     std::vector<std::unique_ptr<IORequest>> ioRequestsBuffer;
     int schedulingAlgorithm = 0;
+    uint64_t migrationPenalty = 0;
+    bool serialPipeline = false;
+    CompletionCallback onCompletion;
+
+    RunQueue runQueue;
+    std::vector<CPUCore *> peers;
+
+    std::atomic<uint64_t> slices{0};
+    std::atomic<uint64_t> steals{0};
+    std::atomic<uint64_t> stealAttempts{0};
+    std::atomic<uint64_t> migrations{0};
+    std::atomic<uint64_t> migrationCycles{0};
+    StatHistogram dispatchWait;
+    mutable std::mutex latencyMutex;
+
+    // Avança com o custo de cada fatia (pipeline + memória), de modo que a
+    // contenção na cache e na RAM atrasa os jobs de tempo real
+    std::atomic<uint64_t> clock{0};
 };
 
-#endif
\ No newline at end of file
+#endif
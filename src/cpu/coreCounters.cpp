@@ -0,0 +1,45 @@
+#include "coreCounters.hpp"
+
+namespace {
+// Mesma ordem de CounterId
+constexpr std::array<std::atomic<uint64_t> PCB::*, COUNTER_COUNT> COUNTER_FIELDS = {
+    &PCB::primary_mem_accesses,
+    &PCB::secondary_mem_accesses,
+    &PCB::memory_cycles,
+    &PCB::mem_accesses_total,
+    &PCB::cache_mem_accesses,
+    &PCB::cache_read_accesses,
+    &PCB::cache_write_accesses,
+    &PCB::pipeline_cycles,
+    &PCB::stage_invocations,
+    &PCB::mem_reads,
+    &PCB::mem_writes,
+    &PCB::cache_write_hits,
+    &PCB::cache_read_hits,
+    &PCB::cache_hits,
+    &PCB::cache_write_misses,
+    &PCB::cache_read_misses,
+    &PCB::cache_misses,
+    &PCB::write_buffer_stall_cycles,
+    &PCB::victim_cache_hits,
+    &PCB::cow_faults,
+    &PCB::instructions_retired,
+};
+} // namespace
+
+std::atomic<uint64_t> PCB::*counterField(CounterId id) {
+    return COUNTER_FIELDS[static_cast<size_t>(id)];
+}
+
+void flushCounters() {
+    CounterBlock &block = localCounters;
+    if (block.owner == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        if (block.values[i] != 0) {
+            (block.owner->*COUNTER_FIELDS[i]).fetch_add(block.values[i], std::memory_order_relaxed);
+            block.values[i] = 0;
+        }
+    }
+}
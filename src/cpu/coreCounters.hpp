@@ -0,0 +1,111 @@
+#ifndef CORE_COUNTERS_HPP
+#define CORE_COUNTERS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "PCB.hpp"
+
+/*
+  Contadores de instrumentação por thread do núcleo.
+
+  Cada thread do pipeline (IF, ID, EX, MEM, WB) soma os eventos do processo da
+  fatia em um bloco próprio, alinhado à linha de cache, com contadores comuns
+  indexados por CounterId. O bloco é descarregado nos atômicos do PCB quando a
+  fatia termina (troca de contexto), então o caminho quente não faz nenhum RMW
+  atômico nem disputa a linha de cache do PCB com as outras threads.
+
+  Fora de uma fatia (carga do programa, IOManager, swap de outro processo) o
+  evento vai direto para o atômico do PCB.
+*/
+
+enum class CounterId : uint8_t {
+    PRIMARY_MEM_ACCESSES,
+    SECONDARY_MEM_ACCESSES,
+    MEMORY_CYCLES,
+    MEM_ACCESSES_TOTAL,
+    CACHE_MEM_ACCESSES,
+    CACHE_READ_ACCESSES,
+    CACHE_WRITE_ACCESSES,
+    PIPELINE_CYCLES,
+    STAGE_INVOCATIONS,
+    MEM_READS,
+    MEM_WRITES,
+    CACHE_WRITE_HITS,
+    CACHE_READ_HITS,
+    CACHE_HITS,
+    CACHE_WRITE_MISSES,
+    CACHE_READ_MISSES,
+    CACHE_MISSES,
+    WRITE_BUFFER_STALL_CYCLES,
+    VICTIM_CACHE_HITS,
+    COW_FAULTS,
+    INSTRUCTIONS_RETIRED,
+    COUNT
+};
+
+constexpr size_t COUNTER_COUNT = static_cast<size_t>(CounterId::COUNT);
+
+struct alignas(64) CounterBlock {
+    PCB *owner = nullptr; // Processo da fatia em andamento (nulo = sem fatia)
+    std::array<uint64_t, COUNTER_COUNT> values{};
+};
+
+inline thread_local CounterBlock localCounters;
+
+// Campo do PCB que recebe cada contador
+std::atomic<uint64_t> PCB::*counterField(CounterId id);
+
+// Soma no PCB o que a thread acumulou e zera o bloco
+void flushCounters();
+
+inline void countEvent(PCB &process, CounterId id, uint64_t amount = 1) {
+    CounterBlock &block = localCounters;
+    if (block.owner == &process) {
+        block.values[static_cast<size_t>(id)] += amount;
+    } else {
+        (process.*counterField(id)).fetch_add(amount, std::memory_order_relaxed);
+    }
+}
+
+// Valor atual do contador, com o que a thread ainda não descarregou no PCB
+inline uint64_t counterValue(PCB &process, CounterId id) {
+    uint64_t value = (process.*counterField(id)).load(std::memory_order_relaxed);
+    if (localCounters.owner == &process) {
+        value += localCounters.values[static_cast<size_t>(id)];
+    }
+    return value;
+}
+
+// Liga o bloco da thread ao processo durante uma fatia; o destrutor descarrega
+class CounterScope {
+   public:
+    explicit CounterScope(PCB &process) {
+        flushCounters();
+        localCounters.owner = &process;
+    }
+    ~CounterScope() {
+        flushCounters();
+        localCounters.owner = nullptr;
+    }
+    CounterScope(const CounterScope &) = delete;
+    CounterScope &operator=(const CounterScope &) = delete;
+};
+
+enum class CacheAccess { READ, WRITE };
+
+// Contabilizar cache
+inline void contabiliza_cache(PCB &pcb, bool hit, CacheAccess access = CacheAccess::READ) {
+    const bool write = access == CacheAccess::WRITE;
+    countEvent(pcb, write ? CounterId::CACHE_WRITE_ACCESSES : CounterId::CACHE_READ_ACCESSES);
+    if (hit) {
+        countEvent(pcb, write ? CounterId::CACHE_WRITE_HITS : CounterId::CACHE_READ_HITS);
+        countEvent(pcb, CounterId::CACHE_HITS);
+    } else {
+        countEvent(pcb, write ? CounterId::CACHE_WRITE_MISSES : CounterId::CACHE_READ_MISSES);
+        countEvent(pcb, CounterId::CACHE_MISSES);
+    }
+}
+
+#endif
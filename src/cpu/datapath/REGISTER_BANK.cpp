@@ -1,8 +1,9 @@
 /*
 Sujeito a alterações - Eduardo
 
-- REGISTER_BANK(): Ele preenche os mapas que associam os nomes dos registradores (ex: "t0") 
-às suas funções de leitura e escrita. É aqui que a mágica do acesso por nome acontece.
+- registerTable(): Tabela estática que associa os nomes dos registradores (ex: "t0")
+aos campos do banco. É aqui que a mágica do acesso por nome acontece; a tabela é
+única e compartilhada por todos os processos.
 
 - readRegister(): Lê um registrador usando o nome como string. Lança um erro se o
 nome for inválido.
@@ -20,85 +21,61 @@ nome for inválido.
 
 namespace hw{
 
-REGISTER_BANK::REGISTER_BANK(){
-    // --- Cada entrada no mapa chama o método read() do registrador correspondente ---
-    acessoLeituraRegistradores = {
-        {"pc",   [this](){ return this->pc.read(); }}, {"mar",  [this](){ return this->mar.read(); }},
-        {"cr",   [this](){ return this->cr.read(); }},  {"epc",  [this](){ return this->epc.read(); }},
-        {"sr",   [this](){ return this->sr.read(); }},  {"hi",   [this](){ return this->hi.read(); }},
-        {"lo",   [this](){ return this->lo.read(); }},  {"ir",   [this](){ return this->ir.read(); }},
-        {"zero", [this](){ return this->zero.read();}},{"at",   [this](){ return this->at.read(); }},
-        {"v0",   [this](){ return this->v0.read(); }},  {"v1",   [this](){ return this->v1.read(); }},
-        {"a0",   [this](){ return this->a0.read(); }},  {"a1",   [this](){ return this->a1.read(); }},
-        {"a2",   [this](){ return this->a2.read(); }},  {"a3",   [this](){ return this->a3.read(); }},
-        {"t0",   [this](){ return this->t0.read(); }},  {"t1",   [this](){ return this->t1.read(); }},
-        {"t2",   [this](){ return this->t2.read(); }},  {"t3",   [this](){ return this->t3.read(); }},
-        {"t4",   [this](){ return this->t4.read(); }},  {"t5",   [this](){ return this->t5.read(); }},
-        {"t6",   [this](){ return this->t6.read(); }},  {"t7",   [this](){ return this->t7.read(); }},
-        {"t8",   [this](){ return this->t8.read(); }},  {"t9",   [this](){ return this->t9.read(); }},
-        {"s0",   [this](){ return this->s0.read(); }},  {"s1",   [this](){ return this->s1.read(); }},
-        {"s2",   [this](){ return this->s2.read(); }},  {"s3",   [this](){ return this->s3.read(); }},
-        {"s4",   [this](){ return this->s4.read(); }},  {"s5",   [this](){ return this->s5.read(); }},
-        {"s6",   [this](){ return this->s6.read(); }},  {"s7",   [this](){ return this->s7.read(); }},
-        {"k0",   [this](){ return this->k0.read(); }},  {"k1",   [this](){ return this->k1.read(); }},
-        {"gp",   [this](){ return this->gp.read(); }},  {"sp",   [this](){ return this->sp.read(); }},
-        {"fp",   [this](){ return this->fp.read(); }},  {"ra",   [this](){ return this->ra.read(); }}
-    };
-
-    // --- Cada entrada no mapa chama o método write() do registrador correspondente ---
-    acessoEscritaRegistradores = {
-        {"pc",   [this](uint32_t v){ this->pc.write(v); }}, {"mar",  [this](uint32_t v){ this->mar.write(v); }},
-        {"cr",   [this](uint32_t v){ this->cr.write(v); }},  {"epc",  [this](uint32_t v){ this->epc.write(v); }},
-        {"sr",   [this](uint32_t v){ this->sr.write(v); }},  {"hi",   [this](uint32_t v){ this->hi.write(v); }},
-        {"lo",   [this](uint32_t v){ this->lo.write(v); }},  {"ir",   [this](uint32_t v){ this->ir.write(v); }},
-        {"at",   [this](uint32_t v){ this->at.write(v); }},
-        {"v0",   [this](uint32_t v){ this->v0.write(v); }},  {"v1",   [this](uint32_t v){ this->v1.write(v); }},
-        {"a0",   [this](uint32_t v){ this->a0.write(v); }},  {"a1",   [this](uint32_t v){ this->a1.write(v); }},
-        {"a2",   [this](uint32_t v){ this->a2.write(v); }},  {"a3",   [this](uint32_t v){ this->a3.write(v); }},
-        {"t0",   [this](uint32_t v){ this->t0.write(v); }},  {"t1",   [this](uint32_t v){ this->t1.write(v); }},
-        {"t2",   [this](uint32_t v){ this->t2.write(v); }},  {"t3",   [this](uint32_t v){ this->t3.write(v); }},
-        {"t4",   [this](uint32_t v){ this->t4.write(v); }},  {"t5",   [this](uint32_t v){ this->t5.write(v); }},
-        {"t6",   [this](uint32_t v){ this->t6.write(v); }},  {"t7",   [this](uint32_t v){ this->t7.write(v); }},
-        {"t8",   [this](uint32_t v){ this->t8.write(v); }},  {"t9",   [this](uint32_t v){ this->t9.write(v); }},
-        {"s0",   [this](uint32_t v){ this->s0.write(v); }},  {"s1",   [this](uint32_t v){ this->s1.write(v); }},
-        {"s2",   [this](uint32_t v){ this->s2.write(v); }},  {"s3",   [this](uint32_t v){ this->s3.write(v); }},
-        {"s4",   [this](uint32_t v){ this->s4.write(v); }},  {"s5",   [this](uint32_t v){ this->s5.write(v); }},
-        {"s6",   [this](uint32_t v){ this->s6.write(v); }},  {"s7",   [this](uint32_t v){ this->s7.write(v); }},
-        {"k0",   [this](uint32_t v){ this->k0.write(v); }},  {"k1",   [this](uint32_t v){ this->k1.write(v); }},
-        {"gp",   [this](uint32_t v){ this->gp.write(v); }},  {"sp",   [this](uint32_t v){ this->sp.write(v); }},
-        {"fp",   [this](uint32_t v){ this->fp.write(v); }},  {"ra",   [this](uint32_t v){ this->ra.write(v); }},
-        
-        // Proteção do registrador ZERO.
-        {"zero", [](uint32_t /*v*/){ /* Nao faz nada */ }}
+namespace {
+// Tabela única de nome -> registrador, compartilhada por todos os bancos. Antes
+// cada PCB montava os próprios mapas de lambdas (~8 KB por processo).
+using RegisterField = REGISTER REGISTER_BANK::*;
+
+const unordered_map<string, RegisterField> &registerTable(){
+    static const unordered_map<string, RegisterField> table = {
+        {"pc", &REGISTER_BANK::pc}, {"mar", &REGISTER_BANK::mar}, {"cr", &REGISTER_BANK::cr},
+        {"epc", &REGISTER_BANK::epc}, {"sr", &REGISTER_BANK::sr}, {"hi", &REGISTER_BANK::hi},
+        {"lo", &REGISTER_BANK::lo}, {"ir", &REGISTER_BANK::ir},
+        {"zero", &REGISTER_BANK::zero}, {"at", &REGISTER_BANK::at},
+        {"v0", &REGISTER_BANK::v0}, {"v1", &REGISTER_BANK::v1},
+        {"a0", &REGISTER_BANK::a0}, {"a1", &REGISTER_BANK::a1}, {"a2", &REGISTER_BANK::a2}, {"a3", &REGISTER_BANK::a3},
+        {"t0", &REGISTER_BANK::t0}, {"t1", &REGISTER_BANK::t1}, {"t2", &REGISTER_BANK::t2}, {"t3", &REGISTER_BANK::t3},
+        {"t4", &REGISTER_BANK::t4}, {"t5", &REGISTER_BANK::t5}, {"t6", &REGISTER_BANK::t6}, {"t7", &REGISTER_BANK::t7},
+        {"t8", &REGISTER_BANK::t8}, {"t9", &REGISTER_BANK::t9},
+        {"s0", &REGISTER_BANK::s0}, {"s1", &REGISTER_BANK::s1}, {"s2", &REGISTER_BANK::s2}, {"s3", &REGISTER_BANK::s3},
+        {"s4", &REGISTER_BANK::s4}, {"s5", &REGISTER_BANK::s5}, {"s6", &REGISTER_BANK::s6}, {"s7", &REGISTER_BANK::s7},
+        {"k0", &REGISTER_BANK::k0}, {"k1", &REGISTER_BANK::k1},
+        {"gp", &REGISTER_BANK::gp}, {"sp", &REGISTER_BANK::sp}, {"fp", &REGISTER_BANK::fp}, {"ra", &REGISTER_BANK::ra}
     };
+    return table;
 }
+} 
 
 uint32_t REGISTER_BANK::readRegister(const string &name) const{
     std::shared_lock<std::shared_mutex> lock(bankMutex);
-    auto it = acessoLeituraRegistradores.find(name);
+    auto it = registerTable().find(name);
 
-    if (it == acessoLeituraRegistradores.end()){
+    if (it == registerTable().end()){
         throw runtime_error("Erro: Tentativa de ler um registrador que nao existe: " + name);
     }
 
-    return it->second();
+    return (this->*(it->second)).read();
 }
 
 void REGISTER_BANK::writeRegister(const string &name, uint32_t value){
     std::unique_lock<std::shared_mutex> lock(bankMutex);
-    auto it = acessoEscritaRegistradores.find(name);
+    auto it = registerTable().find(name);
 
-    if (it == acessoEscritaRegistradores.end()){
+    if (it == registerTable().end()){
         throw runtime_error("Erro: Tentativa de escrever em um registrador que nao existe: " + name);
     }
 
-    it->second(value);
+    // Proteção do registrador ZERO.
+    if (it->second == &REGISTER_BANK::zero){
+        return;
+    }
+    (this->*(it->second)).write(value);
 }
 
 void REGISTER_BANK::reset(){
     std::unique_lock<std::shared_mutex> lock(bankMutex);
-    for (auto const& [name, func] : acessoEscritaRegistradores){
-        func(0);
+    for (auto const& [name, field] : registerTable()){
+        (this->*field).write(0);
     }
 }
 
@@ -9,7 +9,7 @@ instrução.
 Na prática, aqui no nosso código, o REGISTER_BANK é uma classe que agrupa todos
 os registradores do MIPS como objetos individuais. A ideia é que, em vez
 de acessar um registrador por um número (como o registrador 16), a Control Unit
-pode simplesmente pedir pelo nome ("s0"), usando os mapas que a gente criou.
+pode simplesmente pedir pelo nome ("s0"), usando a tabela que a gente criou.
 Isso deixa o código do resto do grupo muito mais fácil de ler e entender.
 
 Este arquivo .hpp é a "interface" da minha parte. Ele só diz o que a classe
@@ -53,14 +53,9 @@ namespace hw{
         REGISTER k0, k1;
         REGISTER gp, sp, fp, ra;
 
-        // --- Mapas de acesso por nome (a interface principal para a Control_Unit) ---
-        unordered_map<string, function<uint32_t()>> acessoLeituraRegistradores;
-        unordered_map<string, function<void(uint32_t)>> acessoEscritaRegistradores;
+        // O acesso por nome usa uma tabela estática compartilhada (ver REGISTER_BANK.cpp)
         mutable std::shared_mutex bankMutex;
 
-        // Construtor: Declarado aqui, implementado no .cpp
-        REGISTER_BANK();
-
         // Leitura segura por nome.
         uint32_t readRegister(const string &name) const;
 
@@ -0,0 +1,91 @@
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+/*
+  Pool de objetos de tamanho fixo: aloca blocos de 'ChunkSize' slots contíguos
+  e reaproveita os slots liberados por uma free list. Usado para a parte fria
+  do PCB (tempo real, MLFQ, saída do programa), que só existe em parte dos
+  processos: com 10^6 PCBs evita uma alocação do malloc (e seu cabeçalho) por
+  bloco e mantém os blocos vizinhos na memória.
+
+  Os blocos nunca voltam ao sistema; ficam para a próxima simulação do mesmo
+  processo (ex.: a próxima rodada do --batch).
+*/
+template <typename T, size_t ChunkSize = 1024>
+class ObjectPool {
+   public:
+    static ObjectPool &instance() {
+        static ObjectPool pool;
+        return pool;
+    }
+
+    template <typename... Args>
+    T *create(Args &&...args) {
+        Slot *slot = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (freeList == nullptr) {
+                grow();
+            }
+            slot = freeList;
+            freeList = slot->next;
+        }
+        return new (slot->storage) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T *object) {
+        if (object == nullptr) {
+            return;
+        }
+        object->~T();
+        Slot *slot = reinterpret_cast<Slot *>(object);
+        std::lock_guard<std::mutex> lock(mutex);
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+   private:
+    union Slot {
+        Slot *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    ObjectPool() = default;
+
+    void grow() {
+        chunks.push_back(std::make_unique<Slot[]>(ChunkSize));
+        Slot *chunk = chunks.back().get();
+        for (size_t i = 0; i < ChunkSize; ++i) {
+            chunk[i].next = freeList;
+            freeList = &chunk[i];
+        }
+    }
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    Slot *freeList = nullptr;
+};
+
+template <typename T>
+struct PoolDeleter {
+    void operator()(T *object) const {
+        ObjectPool<T>::instance().destroy(object);
+    }
+};
+
+template <typename T>
+using PoolPtr = std::unique_ptr<T, PoolDeleter<T>>;
+
+template <typename T, typename... Args>
+PoolPtr<T> makePooled(Args &&...args) {
+    return PoolPtr<T>(ObjectPool<T>::instance().create(std::forward<Args>(args)...));
+}
+
+#endif
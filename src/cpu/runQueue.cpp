@@ -0,0 +1,34 @@
+#include "runQueue.hpp"
+
+RunQueue::RunQueue()
+    : ready(std::make_unique<FifoReadyQueue>()) {}
+
+void RunQueue::setPolicy(std::unique_ptr<ReadyQueue> ready) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->ready = std::move(ready);
+}
+
+void RunQueue::push(PCB *process) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ready->push(process);
+}
+
+PCB *RunQueue::take() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ready->pop();
+}
+
+PCB *RunQueue::steal() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ready->steal();
+}
+
+bool RunQueue::empty() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ready->empty();
+}
+
+std::size_t RunQueue::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ready->size();
+}
@@ -0,0 +1,38 @@
+#ifndef RUN_QUEUE_HPP
+#define RUN_QUEUE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+#include "../process_scheduler/readyQueue.hpp"
+
+struct PCB;
+
+/*
+  Fila de prontos local de um núcleo. O dono retira processos pela política de
+  escalonamento (take); núcleos ociosos roubam pelo outro extremo (steal), como
+  no deque de Chase-Lev. Cada fila tem o próprio mutex, então núcleos
+  diferentes não disputam a mesma trava ao escalonar.
+*/
+
+class RunQueue {
+   public:
+    RunQueue();
+
+    // Troca a estrutura de prontos (deve ser chamada antes de enfileirar)
+    void setPolicy(std::unique_ptr<ReadyQueue> ready);
+
+    void push(PCB *process);
+    PCB *take();
+    PCB *steal();
+
+    bool empty() const;
+    std::size_t size() const;
+
+   private:
+    std::unique_ptr<ReadyQueue> ready;
+    mutable std::mutex mutex;
+};
+
+#endif
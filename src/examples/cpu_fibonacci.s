@@ -0,0 +1,18 @@
+# Fibonacci (CPU Bound), mesma imagem de src/tasks/cpu_fibonacci.json
+.name cpu_fibonacci
+
+.data
+limit:  .word 20
+
+.text
+          li    $t0, 0
+          li    $t1, 1
+          lw    $t2, limit
+          li    $t3, 0
+fib_loop: add   $t4, $t0, $t1
+          add   $t0, $t1, $zero
+          add   $t1, $t4, $zero
+          addi  $t3, $t3, 1
+          blt   $t3, $t2, fib_loop
+          print $t0
+          end
@@ -0,0 +1,15 @@
+# Contagem regressiva simples (mesma imagem de src/tasks/tasks_counter.json)
+.name contador_loop
+
+.data
+current:    .word 0
+start_val:  .word 20
+
+.text
+            lw    $t0, start_val
+loop_start: beq   $t0, $zero, 5
+            print $t0
+            addi  $t0, $t0, -1
+            sw    $t0, current
+            j     loop_start
+end_prog:   end
@@ -1,9 +1,62 @@
 #include <exception>
+#include <filesystem>
 #include <iostream>
+#include <string>
 
+#include "parser_json/programImage.hpp"
+#include "simulator/experimentRunner.hpp"
 #include "simulator/simulator.hpp"
 
-int main() {
+// ./simulador --assemble [diretório]: grava as imagens binárias de src/tasks
+static int assembleTasks(const std::string &cacheDir) {
+    std::vector<std::string> files;
+    for (const auto &entry : std::filesystem::directory_iterator("src/tasks")) {
+        if (entry.is_regular_file() && isProgramSource(entry.path().string())) {
+            files.push_back(entry.path().string());
+        }
+    }
+
+    int failed = 0;
+    for (const auto &image : assembleProgramFiles(files, 0, cacheDir)) {
+        if (!image.error.empty()) {
+            std::cerr << image.source << ": " << image.error << "\n";
+            failed++;
+            continue;
+        }
+        std::cout << image.source << " -> " << imageCachePath(image.source, cacheDir) << " ("
+                  << image.words.size() << " palavras, " << image.symbols.size() << " símbolos)\n";
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    // ./simulador --batch [especificação]: lote de experimentos em um só processo
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        try {
+            ExperimentRunner runner(argc > 2 ? argv[2] : "src/experiments/sweep_example.json");
+            return runner.run();
+        } catch (const std::exception &ex) {
+            std::cerr << "Erro fatal: " << ex.what() << "\n";
+        }
+        return 1;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--assemble") {
+        try {
+            std::string cacheDir = argc > 2 ? argv[2]
+                                            : SystemConfig::loadFromFile("src/system_config/system_config.json")
+                                                  .simulation.image_cache;
+            if (cacheDir.empty()) {
+                std::cerr << "Erro: simulation.image_cache está vazio; informe o diretório.\n";
+                return 1;
+            }
+            return assembleTasks(cacheDir);
+        } catch (const std::exception &ex) {
+            std::cerr << "Erro fatal: " << ex.what() << "\n";
+        }
+        return 1;
+    }
+
     #ifdef _WIN32
         system("cls");
     #else
@@ -0,0 +1,105 @@
+#include "histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+size_t StatHistogram::bucketIndex(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(value));
+    unsigned shift = msb - SUB_BITS;
+    return static_cast<size_t>(SUB_BUCKETS + shift * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS));
+}
+
+uint64_t StatHistogram::bucketLowerBound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    size_t offset = index - SUB_BUCKETS;
+    unsigned shift = static_cast<unsigned>(offset / SUB_BUCKETS);
+    return (SUB_BUCKETS + offset % SUB_BUCKETS) << shift;
+}
+
+uint64_t StatHistogram::bucketUpperBound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index + 1;
+    }
+    unsigned shift = static_cast<unsigned>((index - SUB_BUCKETS) / SUB_BUCKETS);
+    uint64_t lower = bucketLowerBound(index);
+    uint64_t width = uint64_t{1} << shift;
+    // A última faixa vai até 2^64
+    return lower > std::numeric_limits<uint64_t>::max() - width ? std::numeric_limits<uint64_t>::max() : lower + width;
+}
+
+void StatHistogram::sample(uint64_t value, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+    size_t index = bucketIndex(value);
+    if (index >= counts.size()) {
+        counts.resize(index + 1, 0);
+    }
+    counts[index] += count;
+    minimum = samples == 0 ? value : std::min(minimum, value);
+    maximum = std::max(maximum, value);
+    samples += count;
+    sum += value * count;
+}
+
+void StatHistogram::merge(const StatHistogram &other) {
+    if (other.samples == 0) {
+        return;
+    }
+    if (other.counts.size() > counts.size()) {
+        counts.resize(other.counts.size(), 0);
+    }
+    for (size_t i = 0; i < other.counts.size(); ++i) {
+        counts[i] += other.counts[i];
+    }
+    minimum = samples == 0 ? other.minimum : std::min(minimum, other.minimum);
+    maximum = std::max(maximum, other.maximum);
+    samples += other.samples;
+    sum += other.sum;
+}
+
+// Mínimo e máximo do intervalo saem das faixas ocupadas, limitados pelos extremos já vistos
+StatHistogram StatHistogram::since(const StatHistogram &baseline) const {
+    StatHistogram delta;
+    delta.counts = counts;
+    for (size_t i = 0; i < baseline.counts.size() && i < delta.counts.size(); ++i) {
+        delta.counts[i] -= std::min(delta.counts[i], baseline.counts[i]);
+    }
+    delta.samples = samples - std::min(samples, baseline.samples);
+    delta.sum = sum - std::min(sum, baseline.sum);
+    if (delta.samples == 0) {
+        delta.counts.clear();
+        return delta;
+    }
+    auto first = std::find_if(delta.counts.begin(), delta.counts.end(), [](uint64_t n) { return n > 0; });
+    auto last = std::find_if(delta.counts.rbegin(), delta.counts.rend(), [](uint64_t n) { return n > 0; });
+    delta.minimum = std::max(minimum, bucketLowerBound(static_cast<size_t>(first - delta.counts.begin())));
+    delta.maximum = std::min(maximum, bucketUpperBound(static_cast<size_t>(delta.counts.rend() - last - 1)) - 1);
+    return delta;
+}
+
+void StatHistogram::reset() {
+    *this = StatHistogram();
+}
+
+uint64_t StatHistogram::percentile(double p) const {
+    if (samples == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(samples)));
+    rank = std::clamp<uint64_t>(rank, 1, samples);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::clamp(bucketUpperBound(i) - 1, min(), max());
+        }
+    }
+    return max();
+}
@@ -0,0 +1,52 @@
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+  Histograma de latências no estilo HDR: cada potência de 2 é dividida em
+  SUB_BUCKETS faixas de mesma largura, então qualquer valor cai em uma faixa
+  com erro relativo de no máximo 1/SUB_BUCKETS (6,25%). Valores abaixo de
+  SUB_BUCKETS ficam em faixas exatas.
+
+  As faixas são criadas conforme os valores aparecem (latências de cache
+  ocupam poucas dezenas), e dois histogramas se somam com merge(): cada
+  núcleo grava o próprio e o resumo junta todos.
+
+  Não é thread-safe: quem grava protege com o próprio mutex.
+*/
+class StatHistogram {
+   public:
+    static constexpr unsigned SUB_BITS = 4;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t{1} << SUB_BITS;
+
+    void sample(uint64_t value, uint64_t count = 1);
+    void merge(const StatHistogram &other);
+    // Amostras gravadas depois de 'baseline' (um retrato anterior deste histograma)
+    StatHistogram since(const StatHistogram &baseline) const;
+    void reset();
+
+    uint64_t count() const { return samples; }
+    double mean() const { return samples ? static_cast<double>(sum) / samples : 0.0; }
+    uint64_t min() const { return samples ? minimum : 0; }
+    uint64_t max() const { return maximum; }
+    // Percentil por posição (nearest-rank): maior valor da faixa que contém a amostra
+    uint64_t percentile(double p) const;
+
+    size_t buckets() const { return counts.size(); }
+    uint64_t bucketCount(size_t index) const { return index < counts.size() ? counts[index] : 0; }
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketLowerBound(size_t index);
+    static uint64_t bucketUpperBound(size_t index);  // Exclusivo
+
+   private:
+    std::vector<uint64_t> counts;
+    uint64_t samples = 0;
+    uint64_t sum = 0;
+    uint64_t minimum = 0;
+    uint64_t maximum = 0;
+};
+
+#endif
@@ -12,6 +12,8 @@ void print_metrics(const PCB &pcb) {
     std::cout << "Tempo de Início:        " << pcb.startTime << "\n";
     std::cout << "Tempo de Término:       " << pcb.finishTime << "\n";
     std::cout << "Burst Time (CPU):       " << pcb.burstTime << " ciclos\n";
+    std::cout << "Tempo de Serviço:       " << pcb.serviceCycles.load() << " ciclos (pipeline + memória)\n";
+    std::cout << "Tempo Bloqueado:        " << pcb.blockedCycles.load() << " ciclos (I/O e swap-in)\n";
     std::cout << "Turnaround Time:        " << pcb.turnaroundTime << "\n";
     std::cout << "Waiting Time:           " << pcb.waitingTime << "\n";
     std::cout << "Response Time:          " << pcb.responseTime << "\n";
@@ -32,7 +34,21 @@ void print_metrics(const PCB &pcb) {
     std::cout << "Acessos a Mem Principal:" << pcb.primary_mem_accesses.load() << "\n";
     std::cout << "Acessos a Mem Secundaria:" << pcb.secondary_mem_accesses.load() << "\n";
     std::cout << "Ciclos Totais de Memoria: " << pcb.memory_cycles.load() << "\n";
+    std::cout << "Stall do Write Buffer:    " << pcb.write_buffer_stall_cycles.load() << " ciclos\n";
+    std::cout << "Hits na Victim Cache:     " << pcb.victim_cache_hits.load() << "\n";
+    std::cout << "COW Faults:               " << pcb.cow_faults.load() << "\n";
+    std::cout << "Page Faults Assíncronos:  " << pcb.async_page_faults.load() << "\n";
+    std::cout << "Migrações entre Núcleos:  " << pcb.migrations.load()
+              << " (" << pcb.migration_cycles.load() << " ciclos de penalidade)\n";
     std::cout << "Tempo Total de Execução:  " << pcb.totalTimeExecution() << "\n";
+    if (pcb.isPeriodic()) {
+        std::cout << "Tarefa Periódica:         P=" << pcb.rt->rtPeriod << " D=" << pcb.rt->rtDeadline
+                  << " C=" << pcb.rt->rtWcet << "\n";
+        std::cout << "  - Jobs Concluídos:      " << pcb.rt->jobsCompleted << "\n";
+        std::cout << "  - Deadlines Perdidos:   " << pcb.rt->deadlineMisses << "\n";
+        std::cout << "  - Atraso Máximo:        " << pcb.rt->maxLateness << "\n";
+        std::cout << "  - Folga Mínima:         " << pcb.rt->minLaxity << "\n";
+    }
     std::cout << "Cores Utilizados:        ";
     for (const auto& core : pcb.coresAssigned) {
         std::cout << core << " ";
@@ -68,7 +84,9 @@ void print_metrics(const PCB &pcb) {
                 << " | Início: " << pcb.startTime
                 << " | Fim: " << pcb.finishTime << "\n";
 
-        resultados << "BurstTime: " << pcb.burstTime << "\n";
+        resultados << "BurstTime: " << pcb.burstTime
+                << " | Serviço: " << pcb.serviceCycles.load()
+                << " | Bloqueado: " << pcb.blockedCycles.load() << "\n";
 
         resultados << "Turnaround: " << pcb.turnaroundTime
                 << " | Waiting: " << pcb.waitingTime
@@ -84,7 +102,13 @@ void print_metrics(const PCB &pcb) {
         resultados << "  - Writes:    " << pcb.cache_write_accesses.load() << "\n";
         resultados << "     - Hits:    " << pcb.cache_write_hits.load() << "\n";
         resultados << "     - Misses:    " << pcb.cache_write_misses.load() << "\n";
+        resultados << "Stall do Write Buffer: " << pcb.write_buffer_stall_cycles.load() << "\n";
+        resultados << "Hits na Victim Cache: " << pcb.victim_cache_hits.load() << "\n";
+        resultados << "COW Faults: " << pcb.cow_faults.load() << "\n";
+        resultados << "Page Faults Assíncronos: " << pcb.async_page_faults.load() << "\n";
         resultados << "Ciclos de IO: " << pcb.io_cycles << "\n";
+        resultados << "Migrações: " << pcb.migrations.load()
+                   << " | Penalidade: " << pcb.migration_cycles.load() << " ciclos\n";
         resultados << "Tempo Total de Execução: " << pcb.totalTimeExecution() << "\n";
         resultados << "Cores Utilizados: ";
         for (const auto& core : pcb.coresAssigned) {
@@ -0,0 +1,261 @@
+#include "statsRegistry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+using json = nlohmann::json;
+
+namespace {
+// Contadores saem como inteiros; razões e médias como reais
+json number(double value) {
+    if (std::isfinite(value) && value == std::floor(value) && std::fabs(value) < 9.0e15) {
+        return static_cast<int64_t>(value);
+    }
+    return std::isfinite(value) ? json(value) : json(nullptr);
+}
+
+// Pendura 'value' em root["a"]["b"]["c"] para o nome "a.b.c"
+void insertNested(json &root, const std::string &name, const json &value) {
+    json *node = &root;
+    size_t start = 0;
+    while (true) {
+        size_t dot = name.find('.', start);
+        std::string key = name.substr(start, dot - start);
+        if (dot == std::string::npos) {
+            (*node)[key] = value;
+            return;
+        }
+        node = &(*node)[key];
+        start = dot + 1;
+    }
+}
+
+// Resumo com os percentis e as faixas ocupadas ("lt" = limite superior exclusivo)
+json histogramJson(const StatHistogram &histogram) {
+    json buckets = json::array();
+    for (size_t i = 0; i < histogram.buckets(); ++i) {
+        if (histogram.bucketCount(i) > 0) {
+            buckets.push_back({{"lt", StatHistogram::bucketUpperBound(i)}, {"count", histogram.bucketCount(i)}});
+        }
+    }
+    return {{"count", histogram.count()},     {"mean", number(histogram.mean())},
+            {"min", histogram.min()},         {"max", histogram.max()},
+            {"p50", histogram.percentile(50)}, {"p90", histogram.percentile(90)},
+            {"p99", histogram.percentile(99)}, {"p999", histogram.percentile(99.9)},
+            {"buckets", buckets}};
+}
+
+bool hasExtension(const std::string &path, const std::string &extension) {
+    return path.size() >= extension.size() &&
+           path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+} // namespace
+
+// ===================== StatsRegistry =====================
+
+StatsRegistry::Stat &StatsRegistry::add(const std::string &name, Kind kind, const std::string &description) {
+    if (name.empty() || name.front() == '.' || name.back() == '.') {
+        throw std::runtime_error("Nome de estatística inválido: '" + name + "'");
+    }
+    auto [it, inserted] = stats.try_emplace(name);
+    if (!inserted) {
+        throw std::runtime_error("Estatística registrada duas vezes: " + name);
+    }
+    it->second.kind = kind;
+    it->second.description = description;
+    return it->second;
+}
+
+void StatsRegistry::addScalar(const std::string &name, Source source, const std::string &description) {
+    Stat &stat = add(name, Kind::SCALAR, description);
+    stat.source = std::move(source);
+    // Registrado depois de um reset: conta a partir de agora, como os demais
+    stat.baseline = resets > 0 ? stat.source() : 0.0;
+}
+
+void StatsRegistry::addGauge(const std::string &name, Source source, const std::string &description) {
+    add(name, Kind::GAUGE, description).source = std::move(source);
+}
+
+void StatsRegistry::addVector(const std::string &name, std::vector<std::string> elements, VectorSource source,
+                              const std::string &description) {
+    Stat &stat = add(name, Kind::VECTOR, description);
+    stat.elements = std::move(elements);
+    stat.vectorSource = std::move(source);
+    if (resets > 0) {
+        stat.vectorBaseline = stat.vectorSource();
+    }
+}
+
+StatHistogram &StatsRegistry::addHistogram(const std::string &name, const std::string &description) {
+    return add(name, Kind::HISTOGRAM, description).histogram;
+}
+
+void StatsRegistry::addHistogram(const std::string &name, HistogramSource source, const std::string &description) {
+    Stat &stat = add(name, Kind::HISTOGRAM, description);
+    stat.histogramSource = std::move(source);
+    if (resets > 0) {
+        stat.histogramBaseline = stat.histogramSource();
+    }
+}
+
+void StatsRegistry::addFormula(const std::string &name, Formula formula, const std::string &description) {
+    add(name, Kind::FORMULA, description).formula = std::move(formula);
+}
+
+bool StatsRegistry::contains(const std::string &name) const {
+    return stats.count(name) > 0;
+}
+
+double StatsRegistry::value(const std::string &name) const {
+    auto it = stats.find(name);
+    if (it == stats.end()) {
+        throw std::runtime_error("Estatística desconhecida: " + name);
+    }
+    const Stat &stat = it->second;
+    switch (stat.kind) {
+    case Kind::SCALAR:
+        return stat.source() - stat.baseline;
+    case Kind::GAUGE:
+        return stat.source();
+    case Kind::FORMULA:
+        return stat.formula(*this);
+    case Kind::HISTOGRAM:
+        return static_cast<double>(histogramValue(stat).count());
+    case Kind::VECTOR:
+        break;
+    }
+    throw std::runtime_error("Estatística sem valor escalar: " + name);
+}
+
+double StatsRegistry::ratio(const std::string &numerator, const std::string &denominator) const {
+    double below = value(denominator);
+    return below != 0.0 ? value(numerator) / below : 0.0;
+}
+
+StatHistogram StatsRegistry::histogramValue(const Stat &stat) const {
+    return stat.histogramSource ? stat.histogramSource().since(stat.histogramBaseline) : stat.histogram;
+}
+
+std::vector<double> StatsRegistry::vectorValue(const Stat &stat) const {
+    std::vector<double> values = stat.vectorSource();
+    for (size_t i = 0; i < values.size() && i < stat.vectorBaseline.size(); ++i) {
+        values[i] -= stat.vectorBaseline[i];
+    }
+    return values;
+}
+
+json StatsRegistry::current(const Stat &stat) const {
+    switch (stat.kind) {
+    case Kind::SCALAR:
+        return number(stat.source() - stat.baseline);
+    case Kind::GAUGE:
+        return number(stat.source());
+    case Kind::FORMULA:
+        return number(stat.formula(*this));
+    case Kind::HISTOGRAM:
+        return histogramJson(histogramValue(stat));
+    case Kind::VECTOR: {
+        std::vector<double> values = vectorValue(stat);
+        json object = json::object();
+        for (size_t i = 0; i < values.size(); ++i) {
+            object[i < stat.elements.size() ? stat.elements[i] : std::to_string(i)] = number(values[i]);
+        }
+        return object;
+    }
+    }
+    return nullptr;
+}
+
+void StatsRegistry::reset(uint64_t cycle) {
+    for (auto &[name, stat] : stats) {
+        if (stat.kind == Kind::SCALAR) {
+            stat.baseline = stat.source();
+        } else if (stat.kind == Kind::VECTOR) {
+            stat.vectorBaseline = stat.vectorSource();
+        } else if (stat.kind == Kind::HISTOGRAM && stat.histogramSource) {
+            stat.histogramBaseline = stat.histogramSource();
+        } else if (stat.kind == Kind::HISTOGRAM) {
+            stat.histogram.reset();
+        }
+    }
+    resetCycle = cycle;
+    resets++;
+}
+
+void StatsRegistry::dump(uint64_t cycle) {
+    Dump snapshot;
+    snapshot.cycle = cycle;
+    snapshot.values.reserve(stats.size());
+    for (const auto &[name, stat] : stats) {
+        snapshot.values.emplace_back(name, current(stat));
+    }
+    dumps.push_back(std::move(snapshot));
+}
+
+bool StatsRegistry::write(const std::string &path) const {
+    return hasExtension(path, ".csv") ? writeCsv(path) : writeJson(path);
+}
+
+bool StatsRegistry::writeJson(const std::string &path) const {
+    json document;
+    document["reset_cycle"] = resetCycle;
+    document["dumps"] = json::array();
+    for (const auto &snapshot : dumps) {
+        json values = json::object();
+        for (const auto &[name, value] : snapshot.values) {
+            insertNested(values, name, value);
+        }
+        document["dumps"].push_back({{"cycle", snapshot.cycle}, {"stats", values}});
+    }
+    json descriptions = json::object();
+    for (const auto &[name, stat] : stats) {
+        if (!stat.description.empty()) {
+            descriptions[name] = stat.description;
+        }
+    }
+    document["descriptions"] = descriptions;
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir arquivo para salvar as estatísticas: " << path << "\n";
+        return false;
+    }
+    file << document.dump(2) << "\n";
+    return true;
+}
+
+bool StatsRegistry::writeCsv(const std::string &path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir arquivo para salvar as estatísticas: " << path << "\n";
+        return false;
+    }
+    file << "Dump,Cycle,Stat,Value\n";
+    for (size_t d = 0; d < dumps.size(); ++d) {
+        const Dump &snapshot = dumps[d];
+        auto row = [&](const std::string &name, const json &value) {
+            file << d << "," << snapshot.cycle << "," << name << "," << value.dump() << "\n";
+        };
+        for (const auto &[name, value] : snapshot.values) {
+            if (!value.is_object()) {
+                row(name, value);
+                continue;
+            }
+            // Vetores e histogramas viram uma linha por elemento
+            for (const auto &[key, element] : value.items()) {
+                if (key != "buckets") {
+                    row(name + "." + key, element);
+                    continue;
+                }
+                for (const auto &bucket : element) {
+                    row(name + ".lt_" + bucket.at("lt").dump(), bucket.at("count"));
+                }
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,94 @@
+#ifndef STATS_REGISTRY_HPP
+#define STATS_REGISTRY_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../nlohmann/json.hpp"
+#include "histogram.hpp"
+
+/*
+  Registro hierárquico de estatísticas (system.core0.slices, process.3.ipc...).
+
+  Tipos:
+    escalar    -> contador lido do componente na hora (ciclos, acessos, hits)
+    medida     -> valor instantâneo (uso da RAM, tempo de chegada); o reset não o afeta
+    vetor      -> contadores com um rótulo por elemento (misses por conjunto da cache)
+    histograma -> latências em faixas HDR (histogram.hpp), com p50/p90/p99/p999;
+                  do próprio registro ou lido de um componente (ex.: um por núcleo)
+    fórmula    -> calculada de outras estatísticas na hora do dump (taxa de hit, IPC)
+
+  Os componentes continuam donos dos próprios contadores: o registro só guarda
+  como lê-los. reset() marca o valor atual como zero (fim do aquecimento), e
+  cada dump() guarda um retrato de todas as estatísticas no instante simulado.
+  write() grava os retratos em JSON (aninhado pelos pontos do nome) ou em CSV
+  (dump,ciclo,estatística,valor), conforme a extensão do arquivo.
+*/
+
+class StatsRegistry {
+   public:
+    using Source = std::function<double()>;
+    using VectorSource = std::function<std::vector<double>()>;
+    using Formula = std::function<double(const StatsRegistry &)>;
+    using HistogramSource = std::function<StatHistogram()>;
+
+    void addScalar(const std::string &name, Source source, const std::string &description = "");
+    void addGauge(const std::string &name, Source source, const std::string &description = "");
+    void addVector(const std::string &name, std::vector<std::string> elements, VectorSource source,
+                   const std::string &description = "");
+    StatHistogram &addHistogram(const std::string &name, const std::string &description = "");
+    void addHistogram(const std::string &name, HistogramSource source, const std::string &description = "");
+    void addFormula(const std::string &name, Formula formula, const std::string &description = "");
+
+    bool contains(const std::string &name) const;
+    // Valor de um escalar, medida ou fórmula desde o último reset
+    double value(const std::string &name) const;
+    // Razão protegida para fórmulas (0 quando o denominador é 0)
+    double ratio(const std::string &numerator, const std::string &denominator) const;
+
+    void reset(uint64_t cycle);
+    void dump(uint64_t cycle);
+    std::size_t dumpCount() const { return dumps.size(); }
+
+    // .csv grava uma linha por estatística e dump; qualquer outra extensão, JSON
+    bool write(const std::string &path) const;
+
+   private:
+    enum class Kind { SCALAR, GAUGE, VECTOR, HISTOGRAM, FORMULA };
+
+    struct Stat {
+        Kind kind = Kind::SCALAR;
+        std::string description;
+        Source source;
+        VectorSource vectorSource;
+        std::vector<std::string> elements;
+        Formula formula;
+        StatHistogram histogram;
+        HistogramSource histogramSource;
+        StatHistogram histogramBaseline;
+        double baseline = 0.0;
+        std::vector<double> vectorBaseline;
+    };
+
+    struct Dump {
+        uint64_t cycle = 0;
+        std::vector<std::pair<std::string, nlohmann::json>> values;  // Na ordem dos nomes
+    };
+
+    Stat &add(const std::string &name, Kind kind, const std::string &description);
+    nlohmann::json current(const Stat &stat) const;
+    std::vector<double> vectorValue(const Stat &stat) const;
+    StatHistogram histogramValue(const Stat &stat) const;
+    bool writeJson(const std::string &path) const;
+    bool writeCsv(const std::string &path) const;
+
+    std::map<std::string, Stat> stats;
+    std::vector<Dump> dumps;
+    uint64_t resetCycle = 0;
+    uint64_t resets = 0;
+};
+
+#endif
@@ -0,0 +1,374 @@
+#include "parser_asm.hpp"
+
+#include <cctype>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "../system_config/system_config.hpp"
+
+namespace {
+enum class Section { DATA, TEXT };
+
+std::string trim(const std::string &text) {
+    size_t begin = 0;
+    size_t end = text.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(text[begin]))) {
+        begin++;
+    }
+    while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) {
+        end--;
+    }
+    return text.substr(begin, end - begin);
+}
+
+// Remove o comentário ('#' ou ';'), exceto dentro de aspas
+std::string stripComment(const std::string &line) {
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        if (line[i] == '"') {
+            quoted = !quoted;
+        } else if (!quoted && (line[i] == '#' || line[i] == ';')) {
+            return line.substr(0, i);
+        }
+    }
+    return line;
+}
+
+std::vector<std::string> splitOperands(const std::string &text) {
+    std::vector<std::string> operands;
+    if (trim(text).empty()) {
+        return operands;
+    }
+    size_t start = 0;
+    while (true) {
+        size_t comma = text.find(',', start);
+        operands.push_back(trim(text.substr(start, comma - start)));
+        if (operands.back().empty()) {
+            throw std::runtime_error("operando vazio");
+        }
+        if (comma == std::string::npos) {
+            return operands;
+        }
+        start = comma + 1;
+    }
+}
+
+bool isIdentifierChar(char c, bool first) {
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_' || c == '.' ||
+           (!first && std::isdigit(static_cast<unsigned char>(c)));
+}
+
+bool isNumber(const std::string &text) {
+    size_t i = (!text.empty() && (text[0] == '-' || text[0] == '+')) ? 1 : 0;
+    if (i >= text.size()) {
+        return false;
+    }
+    if (text.size() > i + 2 && text[i] == '0' && (text[i + 1] == 'x' || text[i + 1] == 'X')) {
+        for (size_t k = i + 2; k < text.size(); ++k) {
+            if (!std::isxdigit(static_cast<unsigned char>(text[k]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    for (size_t k = i; k < text.size(); ++k) {
+        if (!std::isdigit(static_cast<unsigned char>(text[k]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+long long parseNumber(const std::string &text) {
+    if (!isNumber(text)) {
+        throw std::runtime_error("número inválido: " + text);
+    }
+    return std::stoll(text, nullptr, 0);
+}
+
+std::string requireRegister(const std::string &text) {
+    getRegisterCode(text);
+    return text;
+}
+
+std::string requireNumber(const std::string &text) {
+    parseNumber(text);
+    return text;
+}
+
+// "x($t0)" / "($t0)" -> "x($t0)" / "0($t0)"
+std::string memoryOperand(const std::string &text) {
+    return text[0] == '(' ? "0" + text : text;
+}
+
+// "label", "label+8", "label-4" -> (label, deslocamento em bytes)
+std::pair<std::string, long long> labelOperand(const std::string &text) {
+    size_t sign = text.find_first_of("+-", 1);
+    if (sign == std::string::npos) {
+        return {text, 0};
+    }
+    return {trim(text.substr(0, sign)), parseNumber(trim(text.substr(sign)))};
+}
+
+class AssemblyReader {
+   public:
+    AssemblyReader(int baseAddr, AssemblerContext &context, ProgramImage &image)
+        : baseAddr(baseAddr), context(context), image(image) {}
+
+    void line(const std::string &raw) {
+        std::string text = trim(stripComment(raw));
+
+        // Labels no começo da linha ("a: b: instrução")
+        while (!text.empty() && isIdentifierChar(text[0], true)) {
+            size_t end = 1;
+            while (end < text.size() && isIdentifierChar(text[end], false)) {
+                end++;
+            }
+            size_t colon = end;
+            while (colon < text.size() && std::isspace(static_cast<unsigned char>(text[colon]))) {
+                colon++;
+            }
+            if (colon >= text.size() || text[colon] != ':') {
+                break;
+            }
+            label(text.substr(0, end));
+            text = trim(text.substr(colon + 1));
+        }
+        if (text.empty()) {
+            return;
+        }
+
+        size_t split = 0;
+        while (split < text.size() && !std::isspace(static_cast<unsigned char>(text[split]))) {
+            split++;
+        }
+        std::string word = toLower(text.substr(0, split));
+        std::string rest = trim(text.substr(split));
+        if (word[0] == '.') {
+            directive(word, rest);
+        } else {
+            instruction(word, splitOperands(rest));
+        }
+    }
+
+    void finish() {
+        flushBytes();
+        if (!deadlineSet) {
+            image.rtDeadline = image.rtPeriod;
+        }
+
+        image.words = data;
+        int codeStart = baseAddr + static_cast<int>(data.size() * 4);
+        image.codeOffset = codeStart - baseAddr;
+        parseProgram(program, context, image, codeStart);
+    }
+
+   private:
+    void label(const std::string &name) {
+        if (section == Section::DATA) {
+            if (context.dataMap.count(name)) {
+                throw std::runtime_error("label de dados repetida: " + name);
+            }
+            context.dataMap[name] = baseAddr + static_cast<int>(data.size() * 4);
+        } else {
+            program.push_back({{"label", name}});
+        }
+    }
+
+    void directive(const std::string &name, const std::string &rest) {
+        if (name == ".data") {
+            section = Section::DATA;
+        } else if (name == ".text") {
+            flushBytes();
+            section = Section::TEXT;
+        } else if (name == ".globl" || name == ".global") {
+            // Sem ligação entre programas: só aceita
+        } else if (name == ".word" || name == ".byte" || name == ".space") {
+            if (section != Section::DATA) {
+                throw std::runtime_error(name + " fora de .data");
+            }
+            dataDirective(name, rest);
+        } else {
+            metadata(name, rest);
+        }
+    }
+
+    // Mesmo empacotamento do formato JSON em lista: bytes agrupados em palavras
+    void dataDirective(const std::string &name, const std::string &rest) {
+        if (name == ".space") {
+            bytes.insert(bytes.end(), static_cast<size_t>(parseNumber(rest)), 0);
+            return;
+        }
+        for (const auto &value : splitOperands(rest)) {
+            long long number = parseNumber(value);
+            if (name == ".byte") {
+                bytes.push_back(static_cast<uint8_t>(number));
+            } else {
+                flushBytes();
+                data.push_back(static_cast<uint32_t>(number));
+            }
+        }
+    }
+
+    void flushBytes() {
+        for (size_t i = 0; i < bytes.size(); i += 4) {
+            uint32_t w = 0;
+            for (size_t j = 0; j < 4 && i + j < bytes.size(); ++j) {
+                w = (w << 8) | bytes[i + j];
+            }
+            data.push_back(w);
+        }
+        bytes.clear();
+    }
+
+    void metadata(const std::string &name, const std::string &rest) {
+        image.hasMetadata = true;
+        if (name == ".name") {
+            image.name = rest.size() >= 2 && rest.front() == '"' && rest.back() == '"'
+                             ? rest.substr(1, rest.size() - 2)
+                             : rest;
+        } else if (name == ".period") {
+            image.rtPeriod = static_cast<uint64_t>(parseNumber(rest));
+        } else if (name == ".deadline") {
+            image.rtDeadline = static_cast<uint64_t>(parseNumber(rest));
+            deadlineSet = true;
+        } else if (name == ".wcet") {
+            image.rtWcet = static_cast<uint64_t>(parseNumber(rest));
+        } else if (name == ".jobs") {
+            image.rtJobs = static_cast<int>(parseNumber(rest));
+        } else if (name == ".cache_way_mask") {
+            image.hasCacheWayMask = true;
+            image.cacheWayMask = SystemConfig::parseWayMask(json(rest));
+        } else {
+            throw std::runtime_error("diretiva desconhecida: " + name);
+        }
+    }
+
+    // Monta o nó que o formato JSON usaria para a mesma instrução
+    void instruction(const std::string &mnem, const std::vector<std::string> &ops) {
+        if (section != Section::TEXT) {
+            throw std::runtime_error("instrução fora de .text: " + mnem);
+        }
+        auto expect = [&](size_t count) {
+            if (ops.size() != count) {
+                throw std::runtime_error(mnem + " espera " + std::to_string(count) + " operandos");
+            }
+        };
+
+        json node = {{"instruction", mnem}};
+        if (mnem == "add" || mnem == "sub" || mnem == "and" || mnem == "or" || mnem == "mult" || mnem == "div") {
+            expect(3);
+            node["rd"] = requireRegister(ops[0]);
+            node["rs"] = requireRegister(ops[1]);
+            node["rt"] = requireRegister(ops[2]);
+        } else if (mnem == "sll" || mnem == "srl") {
+            expect(3);
+            node["rd"] = requireRegister(ops[0]);
+            node["rt"] = requireRegister(ops[1]);
+            node["shamt"] = requireNumber(ops[2]);
+        } else if (mnem == "jr") {
+            expect(1);
+            node["rs"] = requireRegister(ops[0]);
+        } else if (mnem == "li") {
+            expect(2);
+            node["rt"] = requireRegister(ops[0]);
+            node["immediate"] = requireNumber(ops[1]);
+        } else if (mnem == "addi" || mnem == "andi" || mnem == "ori" || mnem == "slti") {
+            expect(3);
+            node["rt"] = requireRegister(ops[0]);
+            node["rs"] = requireRegister(ops[1]);
+            node["immediate"] = requireNumber(ops[2]);
+        } else if (mnem == "lw" || mnem == "sw") {
+            expect(2);
+            node["rt"] = requireRegister(ops[0]);
+            if (ops[1].find('(') != std::string::npos) {
+                node["addr"] = memoryOperand(ops[1]);
+            } else {
+                // O formato JSON conta o deslocamento de uma label em palavras
+                auto [name, offset] = labelOperand(ops[1]);
+                if (offset % 4 != 0) {
+                    throw std::runtime_error("deslocamento desalinhado: " + ops[1]);
+                }
+                node["base"] = name;
+                if (offset != 0) {
+                    node["offset"] = offset / 4;
+                }
+            }
+        } else if (mnem == "beq" || mnem == "bne" || mnem == "bgt" || mnem == "blt") {
+            expect(3);
+            node["rs"] = requireRegister(ops[0]);
+            node["rt"] = requireRegister(ops[1]);
+            if (isNumber(ops[2])) {
+                node["offset"] = ops[2];
+            } else {
+                node["dest"] = ops[2];
+            }
+        } else if (mnem == "j" || mnem == "jal") {
+            expect(1);
+            if (isNumber(ops[0])) {
+                node["address"] = ops[0];
+            } else {
+                node["dest"] = ops[0];
+            }
+        } else if (mnem == "print") {
+            if (ops.size() > 1) {
+                expect(1);
+            }
+            if (!ops.empty()) {
+                const std::string &op = ops[0];
+                if (op[0] == '$') {
+                    node["rt"] = requireRegister(op);
+                } else if (op.find('(') != std::string::npos) {
+                    node["addr"] = memoryOperand(op);
+                } else if (isNumber(op)) {
+                    node["immediate"] = op;
+                } else {
+                    node["base"] = op;
+                }
+            }
+        } else if (mnem == "end") {
+            expect(0);
+        } else {
+            throw std::runtime_error("Instrução desconhecida: " + mnem);
+        }
+        program.push_back(std::move(node));
+    }
+
+    int baseAddr;
+    AssemblerContext &context;
+    ProgramImage &image;
+    Section section = Section::TEXT;
+    std::vector<uint32_t> data;
+    std::vector<uint8_t> bytes;
+    json program = json::array();
+    bool deadlineSet = false;
+};
+} // namespace
+
+ProgramImage assembleAssembly(const std::string &source, int baseAddr) {
+    AssemblerContext context;
+    ProgramImage image;
+    image.baseAddress = baseAddr;
+    AssemblyReader reader(baseAddr, context, image);
+
+    size_t start = 0;
+    int lineNumber = 0;
+    while (start < source.size()) {
+        size_t end = source.find('\n', start);
+        if (end == std::string::npos) {
+            end = source.size();
+        }
+        lineNumber++;
+        try {
+            reader.line(source.substr(start, end - start));
+        } catch (const std::exception &ex) {
+            throw std::runtime_error("linha " + std::to_string(lineNumber) + ": " + ex.what());
+        }
+        start = end + 1;
+    }
+
+    reader.finish();
+    collectSymbols(context, image);
+    return image;
+}
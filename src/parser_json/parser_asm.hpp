@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+
+#include "parser_json.hpp"
+
+/*
+  Front end de assembly textual (.s), alternativo ao formato JSON das tasks.
+
+    # comentário (também ';')
+    .name contador          metadata: .name .period .deadline .wcet .jobs .cache_way_mask
+    .data
+    valores: .word 1, 2, 0x10
+    bytes:   .byte 1, 2, 3
+    buffer:  .space 8       (bytes zerados)
+    .text
+    loop:    lw   $t0, valores+4     (label[+/-bytes], offset($reg) ou ($reg))
+             beq  $t0, $zero, fim    (label ou deslocamento em instruções)
+             addi $t0, $t0, -1
+             j    loop
+    fim:     end
+
+  O texto é lido em uma passada só; cada instrução vira o mesmo nó usado pelo
+  formato JSON e passa pelos mesmos encoders, então as duas formas de um
+  programa geram a mesma imagem.
+*/
+
+ProgramImage assembleAssembly(const std::string &source, int baseAddr = 0);
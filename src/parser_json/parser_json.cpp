@@ -1,12 +1,19 @@
 #include "parser_json.hpp"
 #include "../cpu/MemoryManager.hpp" // Alterado de MainMemory.hpp
 #include "../cpu/PCB.hpp"              // Incluído para a função write
+#include "../system_config/system_config.hpp"
+#include "parser_asm.hpp"
+#include "programImage.hpp"
 #include <unordered_map>
 #include <fstream>
 #include <algorithm>
 #include <cctype>
 #include <vector>
 #include <stdexcept>
+#include <atomic>
+#include <filesystem>
+#include <iterator>
+#include <thread>
 
 using namespace std;
 using nlohmann::json;
@@ -36,9 +43,6 @@ const unordered_map<string, int> registerMap = {
     {"$t8",24},{"$t9",25},{"$k0",26},{"$k1",27},{"$gp",28},{"$sp",29},{"$fp",30},{"$ra",31}
 };
 
-static unordered_map<string, int> dataMap;
-static unordered_map<string, int> labelMap;
-
 // ======= Utils e Helpers (sem alterações) =======
 string toLower(string s){
     transform(s.begin(), s.end(), s.begin(), [](unsigned char c){return std::tolower(c);});
@@ -131,7 +135,7 @@ uint32_t encodeRType(const json &j){
     return buildBinaryInstruction(opcode, rs, rt, rd, sh, funct, 0, 0);
 }
 
-uint32_t encodeIType(const json &j, int currentAddress){
+uint32_t encodeIType(const json &j, int currentAddress, AssemblerContext &context){
     string mnem = j.at("instruction").get<string>();
     int opcode  = getOpcode(mnem);
     int rs=0, rt=0; int16_t imm=0;
@@ -155,14 +159,15 @@ uint32_t encodeIType(const json &j, int currentAddress){
         } else if (j.contains("base")){
             rs = getRegisterCode("$zero");
             const string lbl = j.at("base").get<string>();
-            if (!dataMap.count(lbl)) throw runtime_error("Label de dados desconhecida: " + lbl);
-            int baseAddr = dataMap[lbl];
+            if (!context.dataMap.count(lbl)) throw runtime_error("Label de dados desconhecida: " + lbl);
+            int baseAddr = context.dataMap[lbl];
             int off = 0;
             if (j.contains("offset")) {
                 // Offsets in task JSONs index words; convert to bytes (4 per word)
                 off = parseImmediate(j.at("offset")) * 4;
             }
             imm = static_cast<int16_t>((baseAddr + off) & 0xFFFF);
+            context.pendingRelocation = RelocationKind::IMMEDIATE16;
         } else {
             throw runtime_error("lw/sw precisam de 'addr' ou 'baseReg' ou 'base'");
         }
@@ -175,10 +180,10 @@ uint32_t encodeIType(const json &j, int currentAddress){
 
         if (j.contains("dest")){
             const string lbl = j.at("dest").get<string>();
-            if (!labelMap.count(lbl)) throw runtime_error("Label desconhecida: " + lbl);
-            imm = static_cast<int16_t>(labelMap[lbl] - (currentAddress + 1));
+            if (!context.labelMap.count(lbl)) throw runtime_error("Label desconhecida: " + lbl);
+            imm = static_cast<int16_t>(context.labelMap[lbl] - (currentAddress + 1));
 
-            int targetAddr = labelMap[lbl];
+            int targetAddr = context.labelMap[lbl];
             int pcPlus4 = currentAddress + 4;
             int offsetBytes = targetAddr - pcPlus4;
             imm = static_cast<int16_t>(offsetBytes / 4);
@@ -198,15 +203,16 @@ uint32_t encodeIType(const json &j, int currentAddress){
     return buildBinaryInstruction(opcode, rs, rt, 0, 0, 0, imm, 0);
 }
 
-uint32_t encodeJType(const json &j){
+uint32_t encodeJType(const json &j, AssemblerContext &context){
     const string mnem = j.at("instruction").get<string>();
     int opcode = getOpcode(mnem);
 
     if (j.contains("dest")){
         const string lbl = j.at("dest").get<string>();
-        if (!labelMap.count(lbl)) throw runtime_error("Label desconhecida (J): " + lbl);
+        if (!context.labelMap.count(lbl)) throw runtime_error("Label desconhecida (J): " + lbl);
         
-        int addr = labelMap[lbl]; 
+        int addr = context.labelMap[lbl]; 
+        context.pendingRelocation = RelocationKind::JUMP26;
         return buildBinaryInstruction(opcode, 0,0,0,0,0, 0, (addr & 0x03FFFFFF));
     }
     if (j.contains("address")){
@@ -222,7 +228,7 @@ uint32_t encodeJType(const json &j){
     throw runtime_error("J-type requer 'dest' ou 'address'");
 }
 
-uint32_t encodePrintInstruction(const json &j) {
+uint32_t encodePrintInstruction(const json &j, AssemblerContext &context) {
     const int opcode = getOpcode("print");
     int rs = 0;
     int rt = 0;
@@ -244,10 +250,11 @@ uint32_t encodePrintInstruction(const json &j) {
         imm = j.contains("immediate") ? parseImmediate(j.at("immediate")) : 0;
     } else if (j.contains("base")) {
         const string lbl = j.at("base").get<string>();
-        if (!dataMap.count(lbl)) {
+        if (!context.dataMap.count(lbl)) {
             throw runtime_error("Label de dados desconhecida em PRINT: " + lbl);
         }
-        imm = static_cast<int16_t>(dataMap[lbl] & 0xFFFF);
+        imm = static_cast<int16_t>(context.dataMap[lbl] & 0xFFFF);
+        context.pendingRelocation = RelocationKind::IMMEDIATE16;
     } else if (j.contains("address")) {
         imm = parseImmediate(j.at("address"));
     } else if (j.contains("immediate")) {
@@ -257,21 +264,22 @@ uint32_t encodePrintInstruction(const json &j) {
     return buildBinaryInstruction(opcode, rs, rt, 0, 0, 0, imm, 0);
 }
 
-uint32_t parseInstruction(const json &instrJson, int currentInstrIndex){
+uint32_t parseInstruction(const json &instrJson, int currentInstrIndex, AssemblerContext &context){
+    context.pendingRelocation = RelocationKind::NONE;
     const string mnem = instrJson.at("instruction").get<string>();
     if (mnem=="end")
         return static_cast<uint32_t>(getOpcode(mnem)) << 26;
 
     if (mnem=="print")
-        return encodePrintInstruction(instrJson);
+        return encodePrintInstruction(instrJson, context);
 
     if (functMap.count(mnem))              return encodeRType(instrJson);
-    if (mnem=="j" || mnem=="jal")          return encodeJType(instrJson);
-    return encodeIType(instrJson, currentInstrIndex);
+    if (mnem=="j" || mnem=="jal")          return encodeJType(instrJson, context);
+    return encodeIType(instrJson, currentInstrIndex, context);
 }
 
-// ======= Seções (Alteradas para usar MemoryManager) =======
-int parseData(const json &dataJson, MemoryManager &memManager, PCB& pcb, int startAddr){
+// ======= Seções (montam a imagem; a memória só é tocada na instalação) =======
+int parseData(const json &dataJson, AssemblerContext &context, ProgramImage &image, int startAddr){
     int addr = startAddr;
 
     if (dataJson.is_object()){
@@ -279,20 +287,20 @@ int parseData(const json &dataJson, MemoryManager &memManager, PCB& pcb, int sta
             const string key = it.key();
             const json& val  = it.value();
             
-            dataMap[key] = addr;
+            context.dataMap[key] = addr;
             // std::cout << "[DEBUG] Data Label '" << key << "' mapped to: 0x" << std::hex << addr << std::dec << "\n";
 
             if (val.is_array()){
                 for (auto &e : val){
                     int w = e.is_string()? static_cast<int>(std::stoul(e.get<string>(),nullptr,0))
                                           : e.get<int>();
-                    memManager.loadProcessData(addr, w, pcb); // Alterado aqui
+                    image.words.push_back(static_cast<uint32_t>(w));
                     addr += 4;
                 }
             } else {
                 int w = val.is_string()? static_cast<int>(std::stoul(val.get<string>(),nullptr,0))
                                         : val.get<int>();
-                memManager.loadProcessData(addr, w, pcb); // Alterado aqui
+                image.words.push_back(static_cast<uint32_t>(w));
                 addr += 4;
             }
         }
@@ -305,7 +313,7 @@ int parseData(const json &dataJson, MemoryManager &memManager, PCB& pcb, int sta
             for (size_t i=0;i<bytes.size(); i+=4){
                 uint32_t w=0;
                 for (size_t j=0;j<4 && i+j<bytes.size(); ++j) w = (w<<8) | bytes[i+j];
-                memManager.loadProcessData(addr, w, pcb); // Alterado aqui
+                image.words.push_back(static_cast<uint32_t>(w));
                 addr += 4;
             }
             bytes.clear();
@@ -314,7 +322,7 @@ int parseData(const json &dataJson, MemoryManager &memManager, PCB& pcb, int sta
             string type = toLower(item.value("type","word"));
             string label = item.value("label", string());
             if (!label.empty()) {
-                dataMap[label] = addr;
+                context.dataMap[label] = addr;
                 // std::cout << "[DEBUG] Data Label '" << label << "' mapped to: 0x" << std::hex << addr << std::dec << "\n";
             }
 
@@ -324,13 +332,13 @@ int parseData(const json &dataJson, MemoryManager &memManager, PCB& pcb, int sta
                     for (auto &v : item["value"]){
                         int w = v.is_string()? static_cast<int>(std::stoul(v.get<string>(),nullptr,0))
                                              : v.get<int>();
-                        memManager.loadProcessData(addr, w, pcb); // Alterado aqui
+                        image.words.push_back(static_cast<uint32_t>(w));
                         addr += 4;
                     }
                 } else {
                     int w = item["value"].is_string()? static_cast<int>(std::stoul(item["value"].get<string>(),nullptr,0))
                                                       : item["value"].get<int>();
-                    memManager.loadProcessData(addr, w, pcb); // Alterado aqui
+                    image.words.push_back(static_cast<uint32_t>(w));
                     addr += 4;
                 }
             } else if (type=="byte"){
@@ -352,7 +360,7 @@ int parseData(const json &dataJson, MemoryManager &memManager, PCB& pcb, int sta
     return addr;
 }
 
-int parseProgram(const json &programJson, MemoryManager &memManager, PCB& pcb, int startAddr) {
+int parseProgram(const json &programJson, AssemblerContext &context, ProgramImage &image, int startAddr) {
     if (!programJson.is_array()) {
         return startAddr;
     }
@@ -361,15 +369,15 @@ int parseProgram(const json &programJson, MemoryManager &memManager, PCB& pcb, i
     for (const auto &node : programJson) {
         if (node.contains("label")) {
             string lbl = node["label"].get<string>();
-            labelMap[lbl] = startAddr + (instruction_address_counter * 4);
-            // std::cout << "[DEBUG] Code Label '" << lbl << "' mapped to: 0x" << std::hex << labelMap[lbl] << std::dec << "\n";
+            context.labelMap[lbl] = startAddr + (instruction_address_counter * 4);
+            // std::cout << "[DEBUG] Code Label '" << lbl << "' mapped to: 0x" << std::hex << context.labelMap[lbl] << std::dec << "\n";
         }
         if (node.contains("instruction")) {
             instruction_address_counter++;
         }
     }
 
-    pcb.instructions = instruction_address_counter;
+    image.instructions = instruction_address_counter;
     int current_mem_addr = startAddr;
     
     for (const auto &node : programJson) {
@@ -377,13 +385,16 @@ int parseProgram(const json &programJson, MemoryManager &memManager, PCB& pcb, i
             continue;
         }
         
-        uint32_t binary_instruction = parseInstruction(node, current_mem_addr);
+        uint32_t binary_instruction = parseInstruction(node, current_mem_addr, context);
         
         // std::cout << "Instrução " << node.at("instruction").get<string>() << " carregada na memória: 0x" 
         //           << std::hex << current_mem_addr << " : 0x" 
         //           << std::setw(8) << std::setfill('0') << binary_instruction << std::dec << std::endl;
         
-        memManager.loadProcessData(current_mem_addr, binary_instruction, pcb); // Alterado aqui
+        if (context.pendingRelocation != RelocationKind::NONE) {
+            image.relocations.push_back({static_cast<uint32_t>(image.words.size()), context.pendingRelocation});
+        }
+        image.words.push_back(binary_instruction);
         
         current_mem_addr += 4;
     }
@@ -391,31 +402,145 @@ int parseProgram(const json &programJson, MemoryManager &memManager, PCB& pcb, i
     return current_mem_addr;
 }
 
-// ======= Loader (Alterado para usar MemoryManager) =======
-static json readJsonFile(const string &filename){
-    ifstream f(filename);
-    if (!f) throw runtime_error("Não foi possível abrir: " + filename);
-    json j; f >> j; return j;
+// ======= Loader =======
+ProgramImage assembleProgram(const json &j, int baseAddr){
+    AssemblerContext context;
+    ProgramImage image;
+    image.baseAddress = baseAddr;
+
+    if (j.contains("metadata")) {
+        const json &metadata = j["metadata"];
+        image.hasMetadata = true;
+        image.name = metadata.value("name", std::string(""));
+        if (metadata.contains("cache_way_mask")) {
+            image.hasCacheWayMask = true;
+            image.cacheWayMask = SystemConfig::parseWayMask(metadata["cache_way_mask"]);
+        }
+        // Tarefa periódica: deadline relativo e jobs são opcionais
+        image.rtPeriod = metadata.value("period", uint64_t{0});
+        image.rtDeadline = metadata.value("deadline", image.rtPeriod);
+        image.rtWcet = metadata.value("wcet", uint64_t{0});
+        image.rtJobs = metadata.value("jobs", 0);
+    }
+
+    int addr = baseAddr;
+    if (j.contains("data")) {
+        addr = parseData(j["data"], context, image, addr);
+    }
+    image.codeOffset = addr - baseAddr;
+    if (j.contains("program")) {
+        parseProgram(j["program"], context, image, addr);
+    }
+    collectSymbols(context, image);
+    return image;
 }
 
-int loadJsonProgram(const string &filename, MemoryManager &memManager, PCB& pcb, int startAddr){
-    dataMap.clear();
-    labelMap.clear();
+void collectSymbols(const AssemblerContext &context, ProgramImage &image){
+    for (const auto &[label, address] : context.dataMap) {
+        image.symbols.push_back({label, address, false});
+    }
+    for (const auto &[label, address] : context.labelMap) {
+        image.symbols.push_back({label, address, true});
+    }
+    std::sort(image.symbols.begin(), image.symbols.end(), [](const auto &a, const auto &b) {
+        return a.address != b.address ? a.address < b.address : a.name < b.name;
+    });
+}
 
-    json j = readJsonFile(filename);
-    int addr = startAddr;
-    if(j.contains("metadata")) {
-        pcb.name = j["metadata"].value("name", std::string(""));
+bool isProgramSource(const string &filename){
+    const string extension = std::filesystem::path(filename).extension().string();
+    return extension == ".json" || extension == ".s";
+}
+
+ProgramImage assembleSource(const string &filename, const string &content, int baseAddr){
+    if (std::filesystem::path(filename).extension() == ".s") {
+        return assembleAssembly(content, baseAddr);
     }
+    return assembleProgram(json::parse(content), baseAddr);
+}
 
-    if (j.contains("data"))    {
-        // std::cout << "[DEBUG] Parsing Data Section at 0x" << std::hex << addr << std::dec << "\n";
-        addr = parseData(j["data"], memManager, pcb, addr);
+ProgramImage assembleProgramFile(const string &filename, int baseAddr){
+    ProgramImage image;
+    try {
+        ifstream f(filename, std::ios::binary);
+        if (!f) throw runtime_error("Não foi possível abrir: " + filename);
+        string content((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+        image = assembleSource(filename, content, baseAddr);
+    } catch (const std::exception &ex) {
+        image.error = ex.what();
     }
-    int codeStart = addr;
-    if (j.contains("program")) {
-        // std::cout << "[DEBUG] Parsing Code Section at 0x" << std::hex << codeStart << std::dec << "\n";
-        addr = parseProgram(j["program"], memManager, pcb, addr);
+    image.source = filename;
+    return image;
+}
+
+// Cada thread monta arquivos inteiros com o próprio AssemblerContext
+vector<ProgramImage> assembleProgramFiles(const vector<string> &files, unsigned threads, const string &cacheDir){
+    vector<ProgramImage> images(files.size());
+    unsigned workers = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    workers = std::max(1u, std::min<unsigned>(workers, static_cast<unsigned>(files.size())));
+
+    std::atomic<size_t> next{0};
+    auto work = [&](){
+        for (size_t i = next++; i < files.size(); i = next++) {
+            images[i] = loadProgramImage(files[i], cacheDir);
+        }
+    };
+    vector<std::thread> pool;
+    for (unsigned w = 1; w < workers; ++w) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (auto &worker : pool) {
+        worker.join();
+    }
+    return images;
+}
+
+int installProgram(const ProgramImage &image, MemoryManager &memManager, PCB &pcb, int startAddr){
+    if (!image.error.empty()) {
+        throw runtime_error(image.error);
+    }
+
+    if (image.hasMetadata) {
+        pcb.name = image.name;
+        if (image.hasCacheWayMask) {
+            pcb.cacheWayMask = image.cacheWayMask;
+        }
+        pcb.setRealtime(image.rtPeriod, image.rtDeadline, image.rtWcet, image.rtJobs);
+    }
+    pcb.instructions = image.instructions;
+
+    // Endereços absolutos acompanham o deslocamento da base; na mesma base
+    // as palavras vão direto da imagem para a memória, página a página
+    const uint32_t delta = static_cast<uint32_t>(startAddr - image.baseAddress);
+    vector<uint32_t> relocated;
+    if (delta != 0) {
+        relocated = image.words;
+        for (const auto &relocation : image.relocations) {
+            uint32_t &word = relocated[relocation.index];
+            if (relocation.kind == RelocationKind::JUMP26) {
+                word = (word & ~0x03FFFFFFu) | ((word + delta) & 0x03FFFFFFu);
+            } else {
+                word = (word & ~0xFFFFu) | ((word + delta) & 0xFFFFu);
+            }
+        }
     }
-    return codeStart;
-}
\ No newline at end of file
+
+    const vector<uint32_t> &words = delta != 0 ? relocated : image.words;
+    if (memManager.demandPagingEnabled()) {
+        // As páginas só são preenchidas quando o processo as acessar
+        memManager.mapProcessImage(pcb, static_cast<uint32_t>(startAddr),
+                                   static_cast<uint32_t>(startAddr + image.codeOffset), words);
+    } else if (!words.empty()) {
+        memManager.loadProcessImage(static_cast<uint32_t>(startAddr), words.data(), words.size(), pcb);
+    }
+    return startAddr + image.codeOffset;
+}
+
+int loadJsonProgram(const string &filename, MemoryManager &memManager, PCB& pcb, int startAddr){
+    return installProgram(assembleProgramFile(filename, startAddr), memManager, pcb, startAddr);
+}
+
+int loadJsonProgram(const json &j, MemoryManager &memManager, PCB& pcb, int startAddr){
+    return installProgram(assembleProgram(j, startAddr), memManager, pcb, startAddr);
+}
@@ -1,7 +1,9 @@
 #pragma once
 #include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 #include "../nlohmann/json.hpp"
 
 // Forward declarations para evitar inclusões circulares
@@ -10,16 +12,85 @@ struct PCB;
 
 using nlohmann::json;
 
+// Palavra da imagem que guarda um endereço absoluto e precisa ser ajustada
+// quando o programa é instalado em outra base
+enum class RelocationKind {
+    NONE,
+    IMMEDIATE16,  // Campo imediato de 16 bits (lw/sw/print com label de dados)
+    JUMP26        // Campo de endereço de 26 bits (j/jal com label)
+};
+
+// Tabelas de símbolos de uma montagem. Cada programa usa o próprio contexto,
+// então vários programas podem ser montados ao mesmo tempo.
+struct AssemblerContext {
+    std::unordered_map<std::string, int> dataMap;   // Label de dados -> endereço
+    std::unordered_map<std::string, int> labelMap;  // Label de código -> endereço
+    RelocationKind pendingRelocation = RelocationKind::NONE;  // Da última instrução codificada
+};
+
+// Programa montado e ainda fora da memória: dados seguidos do código, a
+// partir de 'baseAddress'. A instalação só copia as palavras (ajustando as
+// realocações) e aplica o metadata ao PCB.
+struct ProgramImage {
+    struct Relocation {
+        uint32_t index;  // Palavra em 'words'
+        RelocationKind kind;
+    };
+    struct Symbol {
+        std::string name;
+        int address;
+        bool code;  // Label de código (false = label de dados)
+    };
+
+    std::string source;
+    std::string error;  // Falha na leitura ou na montagem (vazio = ok)
+
+    bool hasMetadata = false;
+    std::string name;
+    bool hasCacheWayMask = false;
+    uint64_t cacheWayMask = 0;
+    uint64_t rtPeriod = 0;
+    uint64_t rtDeadline = 0;
+    uint64_t rtWcet = 0;
+    int rtJobs = 0;
+
+    int baseAddress = 0;
+    int codeOffset = 0;    // Início do código, em bytes a partir da base
+    int instructions = 0;
+    std::vector<uint32_t> words;
+    std::vector<Relocation> relocations;
+    std::vector<Symbol> symbols;  // Ordenados por endereço
+};
+
 // ===== API principal =====
-// Agora recebe MemoryManager e PCB para carregar o programa
+// Fase de montagem: só lê o documento, sem tocar na memória (pode rodar em paralelo)
+ProgramImage assembleProgram(const json &program, int baseAddr = 0);
+// Task em JSON ou em assembly (.s, parser_asm.hpp), escolhida pela extensão
+bool isProgramSource(const std::string &filename);
+ProgramImage assembleSource(const std::string &filename, const std::string &content, int baseAddr = 0);
+// Erros de leitura e de montagem ficam em ProgramImage::error
+ProgramImage assembleProgramFile(const std::string &filename, int baseAddr = 0);
+// Monta vários arquivos em um pool de threads (0 = núcleos do hospedeiro); mesma ordem de 'files'.
+// Com 'cacheDir', imagens binárias ainda válidas (programImage.hpp) dispensam a montagem.
+std::vector<ProgramImage> assembleProgramFiles(const std::vector<std::string> &files, unsigned threads = 0,
+                                               const std::string &cacheDir = "");
+// Fase de instalação (serial): grava a imagem no espaço do processo a partir de
+// 'startAddr' (ou só a registra, com paginação sob demanda). Retorna o endereço
+// da primeira instrução.
+int installProgram(const ProgramImage &image, MemoryManager &memManager, PCB &pcb, int startAddr);
+
+// Monta e instala em seguida
 int loadJsonProgram(const std::string &filename, MemoryManager &memManager, PCB& pcb, int startAddr);
+int loadJsonProgram(const json &program, MemoryManager &memManager, PCB& pcb, int startAddr);
 
 // ===== Parsers de seção =====
-int parseData(const json &dataJson, MemoryManager &memManager, PCB& pcb, int startAddr);
-int parseProgram(const json &programJson, MemoryManager &memManager, PCB& pcb, int startAddr);
+// Tabela de símbolos da imagem a partir das labels do contexto
+void collectSymbols(const AssemblerContext &context, ProgramImage &image);
+int parseData(const json &dataJson, AssemblerContext &context, ProgramImage &image, int startAddr);
+int parseProgram(const json &programJson, AssemblerContext &context, ProgramImage &image, int startAddr);
 
 // ===== Parser de instrução =====
-uint32_t parseInstruction(const json &instrJson, int currentInstrIndex);
+uint32_t parseInstruction(const json &instrJson, int currentInstrIndex, AssemblerContext &context);
 
 // ===== Helpers / Encoders =====
 int     getRegisterCode(const std::string &reg);
@@ -30,11 +101,11 @@ uint32_t buildBinaryInstruction(int opcode, int rs, int rt, int rd, int shamt, i
                                 int immediate, int address);
 
 uint32_t encodeRType(const nlohmann::json &instrJson);
-uint32_t encodeIType(const nlohmann::json &instrJson, int currentAddress);
-uint32_t encodeJType(const nlohmann::json &instrJson);
-uint32_t encodePrintInstruction(const json &j);
+uint32_t encodeIType(const nlohmann::json &instrJson, int currentAddress, AssemblerContext &context);
+uint32_t encodeJType(const nlohmann::json &instrJson, AssemblerContext &context);
+uint32_t encodePrintInstruction(const json &j, AssemblerContext &context);
 
 // ===== Utils =====
 std::pair<int16_t,int> parseOffsetBase(const std::string &addrExpr);
 int16_t   parseImmediate(const json &j);
-std::string toLower(std::string s);
\ No newline at end of file
+std::string toLower(std::string s);
@@ -0,0 +1,283 @@
+#include "programImage.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr char IMAGE_MAGIC[8] = {'M', 'I', 'P', 'S', 'I', 'M', 'G', '\0'};
+constexpr uint32_t IMAGE_VERSION = 1;
+constexpr uint32_t FLAG_METADATA = 1u << 0;
+constexpr uint32_t FLAG_CACHE_WAY_MASK = 1u << 1;
+
+struct ImageHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t sourceHash;
+    int32_t baseAddress;
+    int32_t codeOffset;
+    int32_t instructions;
+    int32_t rtJobs;
+    uint64_t cacheWayMask;
+    uint64_t rtPeriod;
+    uint64_t rtDeadline;
+    uint64_t rtWcet;
+    uint32_t dataWords;
+    uint32_t textWords;
+    uint32_t relocations;
+    uint32_t symbols;
+    uint32_t nameLength;
+    uint32_t stringBytes;
+};
+
+struct RelocationRecord {
+    uint32_t index;
+    uint32_t kind;
+};
+
+struct SymbolRecord {
+    int32_t address;
+    uint32_t code;
+    uint32_t nameOffset;  // Na seção de strings
+    uint32_t nameLength;
+};
+
+static_assert(sizeof(ImageHeader) % 4 == 0, "cabeçalho deve manter o alinhamento das palavras");
+
+template <typename T>
+void append(std::string &buffer, const T &value) {
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// Arquivo inteiro mapeado somente para leitura (cópia em memória no Windows)
+class MappedFile {
+   public:
+    explicit MappedFile(const std::string &path) {
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+            void *mapped = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                bytes = static_cast<const char *>(mapped);
+                length = static_cast<size_t>(info.st_size);
+            }
+        }
+        ::close(fd);
+#else
+        std::ifstream file(path, std::ios::binary);
+        copy.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        bytes = copy.data();
+        length = copy.size();
+#endif
+    }
+    ~MappedFile() {
+#ifndef _WIN32
+        if (bytes != nullptr) {
+            ::munmap(const_cast<char *>(bytes), length);
+        }
+#endif
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const {
+        return bytes;
+    }
+    size_t size() const {
+        return length;
+    }
+
+   private:
+    const char *bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    std::string copy;
+#endif
+};
+} // namespace
+
+uint64_t contentHash(const std::string &bytes) {
+    uint64_t hash = 1469598103934665603ull;
+    for (unsigned char c : bytes) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string imageCachePath(const std::string &filename, const std::string &cacheDir) {
+    return (std::filesystem::path(cacheDir) / std::filesystem::path(filename).filename()).string() + ".mimg";
+}
+
+bool writeImageFile(const ProgramImage &image, uint64_t sourceHash, const std::string &path) {
+    std::string strings = image.name;
+    std::vector<SymbolRecord> symbols;
+    for (const auto &symbol : image.symbols) {
+        symbols.push_back({symbol.address, symbol.code ? 1u : 0u, static_cast<uint32_t>(strings.size()),
+                           static_cast<uint32_t>(symbol.name.size())});
+        strings += symbol.name;
+    }
+    strings.resize((strings.size() + 3) / 4 * 4, '\0');
+
+    ImageHeader header{};
+    std::memcpy(header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    header.version = IMAGE_VERSION;
+    header.flags = (image.hasMetadata ? FLAG_METADATA : 0) | (image.hasCacheWayMask ? FLAG_CACHE_WAY_MASK : 0);
+    header.sourceHash = sourceHash;
+    header.baseAddress = image.baseAddress;
+    header.codeOffset = image.codeOffset;
+    header.instructions = image.instructions;
+    header.rtJobs = image.rtJobs;
+    header.cacheWayMask = image.cacheWayMask;
+    header.rtPeriod = image.rtPeriod;
+    header.rtDeadline = image.rtDeadline;
+    header.rtWcet = image.rtWcet;
+    header.dataWords = static_cast<uint32_t>(image.codeOffset / 4);
+    header.textWords = static_cast<uint32_t>(image.words.size()) - header.dataWords;
+    header.relocations = static_cast<uint32_t>(image.relocations.size());
+    header.symbols = static_cast<uint32_t>(symbols.size());
+    header.nameLength = static_cast<uint32_t>(image.name.size());
+    header.stringBytes = static_cast<uint32_t>(strings.size());
+
+    std::string buffer;
+    append(buffer, header);
+    buffer.append(reinterpret_cast<const char *>(image.words.data()), image.words.size() * sizeof(uint32_t));
+    for (const auto &relocation : image.relocations) {
+        append(buffer, RelocationRecord{relocation.index, static_cast<uint32_t>(relocation.kind)});
+    }
+    for (const auto &symbol : symbols) {
+        append(buffer, symbol);
+    }
+    buffer += strings;
+
+    // Grava ao lado e renomeia: outro simulador nunca vê uma imagem pela metade
+    std::error_code error;
+    std::filesystem::path target(path);
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path(), error);
+    }
+    std::string temporary = path + ".tmp" +
+                            std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                                           static_cast<size_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+            return false;
+        }
+    }
+    std::filesystem::rename(temporary, target, error);
+    return !error;
+}
+
+bool readImageFile(const std::string &path, uint64_t sourceHash, ProgramImage &image) {
+    MappedFile file(path);
+    if (file.data() == nullptr || file.size() < sizeof(ImageHeader)) {
+        return false;
+    }
+
+    ImageHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0 || header.version != IMAGE_VERSION ||
+        header.sourceHash != sourceHash) {
+        return false;
+    }
+
+    const size_t wordCount = size_t{header.dataWords} + header.textWords;
+    const size_t expected = sizeof(ImageHeader) + wordCount * sizeof(uint32_t) +
+                            size_t{header.relocations} * sizeof(RelocationRecord) +
+                            size_t{header.symbols} * sizeof(SymbolRecord) + header.stringBytes;
+    if (file.size() != expected || header.nameLength > header.stringBytes) {
+        return false;
+    }
+
+    const char *cursor = file.data() + sizeof(ImageHeader);
+    ProgramImage loaded;
+    loaded.hasMetadata = (header.flags & FLAG_METADATA) != 0;
+    loaded.hasCacheWayMask = (header.flags & FLAG_CACHE_WAY_MASK) != 0;
+    loaded.cacheWayMask = header.cacheWayMask;
+    loaded.rtPeriod = header.rtPeriod;
+    loaded.rtDeadline = header.rtDeadline;
+    loaded.rtWcet = header.rtWcet;
+    loaded.rtJobs = header.rtJobs;
+    loaded.baseAddress = header.baseAddress;
+    loaded.codeOffset = header.codeOffset;
+    loaded.instructions = header.instructions;
+
+    // Segmentos de dados e de texto são contíguos: uma cópia só
+    loaded.words.resize(wordCount);
+    std::memcpy(loaded.words.data(), cursor, wordCount * sizeof(uint32_t));
+    cursor += wordCount * sizeof(uint32_t);
+
+    for (uint32_t r = 0; r < header.relocations; ++r) {
+        RelocationRecord record;
+        std::memcpy(&record, cursor, sizeof(record));
+        cursor += sizeof(record);
+        if (record.index >= wordCount || record.kind > static_cast<uint32_t>(RelocationKind::JUMP26)) {
+            return false;
+        }
+        loaded.relocations.push_back({record.index, static_cast<RelocationKind>(record.kind)});
+    }
+
+    const char *strings = cursor + size_t{header.symbols} * sizeof(SymbolRecord);
+    for (uint32_t s = 0; s < header.symbols; ++s) {
+        SymbolRecord record;
+        std::memcpy(&record, cursor, sizeof(record));
+        cursor += sizeof(record);
+        if (size_t{record.nameOffset} + record.nameLength > header.stringBytes) {
+            return false;
+        }
+        loaded.symbols.push_back({std::string(strings + record.nameOffset, record.nameLength), record.address,
+                                  record.code != 0});
+    }
+    loaded.name.assign(strings, header.nameLength);
+
+    image = std::move(loaded);
+    return true;
+}
+
+ProgramImage loadProgramImage(const std::string &filename, const std::string &cacheDir) {
+    ProgramImage image;
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        image.error = "Não foi possível abrir: " + filename;
+        image.source = filename;
+        return image;
+    }
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const uint64_t hash = contentHash(bytes);
+
+    const std::string cachePath = cacheDir.empty() ? std::string() : imageCachePath(filename, cacheDir);
+    if (!cachePath.empty() && readImageFile(cachePath, hash, image)) {
+        image.source = filename;
+        return image;
+    }
+
+    try {
+        image = assembleSource(filename, bytes);
+    } catch (const std::exception &ex) {
+        image = ProgramImage();
+        image.error = ex.what();
+    }
+    image.source = filename;
+    if (!cachePath.empty() && image.error.empty()) {
+        writeImageFile(image, hash, cachePath);
+    }
+    return image;
+}
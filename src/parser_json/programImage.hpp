@@ -0,0 +1,38 @@
+#ifndef PROGRAM_IMAGE_HPP
+#define PROGRAM_IMAGE_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "parser_json.hpp"
+
+/*
+  Imagem binária de um programa montado (.mimg), usada como cache da montagem:
+
+    cabeçalho     -> "MIPSIMG", versão, hash do JSON de origem, base, início
+                     do código, metadata e tamanho de cada seção
+    dados         -> palavras do segmento de dados
+    texto         -> palavras do segmento de código
+    realocações   -> (palavra, tipo) das palavras com endereço absoluto
+    símbolos      -> (endereço, dados/código, nome) de cada label
+    strings       -> nome do processo seguido dos nomes dos símbolos
+
+  Tudo em little-endian, alinhado a 4 bytes. O arquivo é mapeado com mmap e
+  só é aceito se o hash gravado for o do JSON atual: editar a task invalida a
+  imagem, que é montada e gravada de novo.
+*/
+
+// FNV-1a de 64 bits do conteúdo do arquivo de origem
+uint64_t contentHash(const std::string &bytes);
+
+bool writeImageFile(const ProgramImage &image, uint64_t sourceHash, const std::string &path);
+// false se o arquivo não existir, estiver corrompido ou vier de outro JSON
+bool readImageFile(const std::string &path, uint64_t sourceHash, ProgramImage &image);
+
+// Lê a task (JSON ou .s); com 'cacheDir' não vazio reaproveita a imagem gravada ou monta e
+// grava uma nova. Erros ficam em ProgramImage::error.
+ProgramImage loadProgramImage(const std::string &filename, const std::string &cacheDir);
+// Caminho da imagem de 'filename' dentro de 'cacheDir'
+std::string imageCachePath(const std::string &filename, const std::string &cacheDir);
+
+#endif
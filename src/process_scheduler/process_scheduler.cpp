@@ -1,7 +1,8 @@
 #include "process_scheduler.hpp"
 #include "scheduler.hpp"
 
-ProcessScheduler::ProcessScheduler(int schedulerInt, vector<PCB *> process)
+ProcessScheduler::ProcessScheduler(int schedulerInt, vector<PCB *> process, uint64_t seed)
+    : seed(seed), rng(static_cast<mt19937::result_type>(deriveSeed(seed, SeedStream::SCHEDULER)))
 {
     this->schedulerInt = schedulerInt;
     this->process = process;
@@ -24,25 +25,44 @@ ProcessScheduler::ProcessScheduler(int schedulerInt, vector<PCB *> process)
     case 3:
         this->setPriority();
         break;
+
+    case 6:
+        // O CFS deriva os pesos da prioridade
+        this->setPriority();
+        break;
     default:
         break;
     }
 }
 
-void ProcessScheduler::setQuantum()
+// Um gerador por posição: o valor do processo não depende da ordem das chegadas
+int ProcessScheduler::seededQuantum(size_t index) const
 {
-    for (int i = 0; i < this->process.size(); i++)
-    {
-        int min_val = 5;
-        int max_val = 30;
-        unsigned seed = 42 + i; // Seed fixa para reprodutibilidade
-        mt19937 rng(seed);
+    int min_val = 5;
+    int max_val = 30;
+    mt19937 rng(static_cast<mt19937::result_type>(deriveSeed(this->seed, SeedStream::QUANTUM, index)));
 
-        uniform_int_distribution<int> dist(min_val, max_val);
+    uniform_int_distribution<int> dist(min_val, max_val);
 
-        int random_number = dist(rng);
+    return dist(rng);
+}
+
+int ProcessScheduler::seededPriority(size_t index) const
+{
+    int min_val = 0;
+    int max_val = 5;
+    mt19937 rng(static_cast<mt19937::result_type>(deriveSeed(this->seed, SeedStream::PRIORITY, index)));
+
+    uniform_int_distribution<int> dist(min_val, max_val);
+
+    return dist(rng);
+}
 
-        this->process.at(i)->quantum = random_number;
+void ProcessScheduler::setQuantum()
+{
+    for (int i = 0; i < this->process.size(); i++)
+    {
+        this->process.at(i)->quantum = seededQuantum(i);
     }
 }
 
@@ -50,16 +70,51 @@ void ProcessScheduler::setPriority()
 {
     for (int i = 0; i < this->process.size(); i++)
     {
-        int min_val = 0;
-        int max_val = 5;
-        unsigned seed = 616 + i;
-        mt19937 rng(seed);
+        this->process.at(i)->priority = seededPriority(i);
+    }
+}
 
-        uniform_int_distribution<int> dist(min_val, max_val);
+// Processo que chegou durante a simulação: recebe os mesmos parâmetros que
+// teria recebido na carga inicial, sem alterar os processos já em execução
+void ProcessScheduler::admit(PCB *process)
+{
+    size_t index = this->process.size();
+    this->process.push_back(process);
 
-        int random_number = dist(rng);
+    switch (this->schedulerInt)
+    {
+    case 0:
+    case 1:
+        process->quantum = seededQuantum(index);
+        break;
 
-        this->process.at(i)->priority = random_number;
+    case 2:
+    {
+        process->quantum = seededQuantum(index);
+        int maxInstr = 0;
+        for (auto *p : this->process)
+        {
+            maxInstr = std::max(maxInstr, p->instructions);
+        }
+        int scaled = maxInstr > 0
+                         ? static_cast<int>((static_cast<double>(process->instructions) / maxInstr) * 20 + 0.5)
+                         : 1;
+        process->tickets = std::max(1, scaled);
+        break;
+    }
+
+    case 3:
+    case 6:
+        process->priority = seededPriority(index);
+        break;
+
+    case 7:
+    case 8:
+        process->quantum = this->realtimeQuantum;
+        break;
+
+    default:
+        break;
     }
 }
 
@@ -96,7 +151,7 @@ void ProcessScheduler::setTickets()
     }
 }
 
-PCB *ProcessScheduler::scheduler(vector<PCB *> process)
+PCB *ProcessScheduler::scheduler(const vector<PCB *> &process)
 {
 
     switch (this->schedulerInt)
@@ -123,7 +178,7 @@ PCB *ProcessScheduler::scheduler(vector<PCB *> process)
     }
 }
 
-PCB *ProcessScheduler::shortest_job_first(vector<PCB *> process)
+PCB *ProcessScheduler::shortest_job_first(const vector<PCB *> &process)
 {
     if (process.empty())
         return nullptr;
@@ -140,14 +195,14 @@ PCB *ProcessScheduler::shortest_job_first(vector<PCB *> process)
     return selected_process;
 }
 
-PCB *ProcessScheduler::round_robin(vector<PCB *> process)
+PCB *ProcessScheduler::round_robin(const vector<PCB *> &process)
 {
     if (process.empty())
         return nullptr;
     return process.front();
 }
 
-PCB *ProcessScheduler::priority(vector<PCB *> process)
+PCB *ProcessScheduler::priority(const vector<PCB *> &process)
 {
     if (process.empty())
         return nullptr;
@@ -177,7 +232,11 @@ PCB *ProcessScheduler::lotterySelect(const std::vector<PCB *> &readyQueue)
         total += std::max(1, p->tickets);
     }
     std::uniform_int_distribution<uint64_t> dist(1, total);
-    uint64_t pick = dist(rng);
+    uint64_t pick = 0;
+    {
+        std::lock_guard<std::mutex> lock(rngMutex);
+        pick = dist(rng);
+    }
     for (auto *p : readyQueue)
     {
         uint64_t t = std::max(1, p->tickets);
@@ -188,9 +247,138 @@ PCB *ProcessScheduler::lotterySelect(const std::vector<PCB *> &readyQueue)
     return readyQueue.front();
 }
 
-PCB *ProcessScheduler::first_come_first_served(vector<PCB *> process)
+PCB *ProcessScheduler::first_come_first_served(const vector<PCB *> &process)
 {
     if (process.empty())
         return nullptr;
     return process.front();
+}
+
+std::unique_ptr<ReadyQueue> ProcessScheduler::makeReadyQueue(std::size_t coreId) const
+{
+    if (this->schedulerInt == 5)
+    {
+        return std::make_unique<MlfqReadyQueue>(this->mlfq);
+    }
+    if (this->schedulerInt == 6)
+    {
+        return std::make_unique<CfsReadyQueue>(this->cfs);
+    }
+    return ::makeReadyQueue(this->schedulerInt, deriveSeed(this->seed, SeedStream::READY_QUEUE, coreId));
+}
+
+void ProcessScheduler::configureMlfq(int levels, const std::vector<int> &quanta, int boostInterval)
+{
+    levels = std::clamp(levels, 1, MLFQ_MAX_LEVELS);
+
+    // Níveis sem quantum explícito dobram o quantum do nível anterior
+    std::vector<int> perLevel;
+    for (int level = 0; level < levels; level++)
+    {
+        if (level < static_cast<int>(quanta.size()) && quanta[level] > 0)
+            perLevel.push_back(quanta[level]);
+        else
+            perLevel.push_back(perLevel.empty() ? 8 : perLevel.back() * 2);
+    }
+
+    this->mlfq->levels = levels;
+    this->mlfq->quanta = perLevel;
+    this->mlfqBoostInterval = std::max(0, boostInterval);
+}
+
+void ProcessScheduler::configureCfs(int targetLatency, int minGranularity)
+{
+    this->cfs->minGranularity = static_cast<uint64_t>(std::max(1, minGranularity));
+    this->cfs->targetLatency = static_cast<uint64_t>(std::max(targetLatency, minGranularity));
+}
+
+void ProcessScheduler::configureRealtime(int quantum, int jobs)
+{
+    this->realtimeJobs = std::max(1, jobs);
+    this->realtimeQuantum = std::max(1, quantum);
+    if (this->schedulerInt != 7 && this->schedulerInt != 8)
+        return;
+
+    for (auto *p : this->process)
+    {
+        p->quantum = this->realtimeQuantum;
+    }
+}
+
+bool ProcessScheduler::releaseNextJob(PCB &process)
+{
+    if (!process.isPeriodic())
+        return false;
+
+    RealtimeState &rt = *process.rt;
+
+    // O job terminou no fim da última fatia, no relógio do núcleo
+    int64_t lateness = static_cast<int64_t>(process.lastRunEnd) - static_cast<int64_t>(rt.absoluteDeadline);
+    rt.maxLateness = std::max(rt.maxLateness, lateness);
+    if (lateness > 0)
+    {
+        rt.deadlineMisses++;
+        rt.totalTardiness += static_cast<uint64_t>(lateness);
+    }
+    rt.maxJobCycles = std::max(rt.maxJobCycles, rt.jobCycles);
+    rt.jobsCompleted++;
+
+    int jobs = rt.rtJobs > 0 ? rt.rtJobs : this->realtimeJobs;
+    if (rt.jobsCompleted >= jobs)
+        return false;
+
+    rt.releaseTime += rt.rtPeriod;
+    rt.absoluteDeadline = rt.releaseTime + rt.rtDeadline;
+    rt.jobCycles = 0;
+    process.regBank.pc.write(process.entryPC);
+    return true;
+}
+
+double ProcessScheduler::shareWeight(const PCB &process) const
+{
+    if (this->schedulerInt == 6)
+        return cfsWeight(process.priority);
+    return 1.0;
+}
+
+void ProcessScheduler::onSliceEnd(PCB &process)
+{
+    if (this->schedulerInt == 6)
+    {
+        int used = std::max(0, process.timeStamp - process.sliceStart);
+        process.vruntime.fetch_add(cfsVruntimeDelta(static_cast<uint64_t>(used), cfsWeight(process.priority)));
+        return;
+    }
+
+    if (this->schedulerInt != 5)
+        return;
+
+    int level = process.mlfqSliceLevel;
+    int used = process.timeStamp - process.sliceStart;
+    MlfqStats &stats = process.mlfqStats();
+    stats.slices[level].fetch_add(1);
+    stats.cycles[level].fetch_add(static_cast<uint64_t>(std::max(0, used)));
+
+    State state = process.state.load();
+    if (state == State::Blocked && !process.pendingPageFault.load())
+    {
+        // Bloqueou por I/O antes do fim do quantum: comportamento interativo
+        process.mlfqLevel.store(std::max(0, level - 1));
+    }
+    else if (state != State::Finished && state != State::Blocked && used >= process.quantum)
+    {
+        process.mlfqLevel.store(std::min(this->mlfq->levels - 1, level + 1));
+    }
+
+    // Boost periódico: todos voltam ao nível 0 para evitar starvation
+    this->mlfqCompletedSlices++;
+    if (this->mlfqBoostInterval > 0 && this->mlfqCompletedSlices % this->mlfqBoostInterval == 0)
+    {
+        for (auto *p : this->process)
+        {
+            p->mlfqLevel.store(0);
+        }
+        this->mlfq->boostEpoch.fetch_add(1);
+        this->mlfqBoosts++;
+    }
 }
\ No newline at end of file
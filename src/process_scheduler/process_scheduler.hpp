@@ -3,8 +3,12 @@
 
 #include "../cpu/PCB.hpp"
 #include "scheduler.hpp"
+#include "readyQueue.hpp"
+#include "../system_config/system_config.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <cstddef>
 #include <unordered_map>
 #include <vector>
@@ -12,6 +16,7 @@
 #include <iostream>
 #include <random>
 #include <chrono>
+#include <mutex>
 using namespace std;
 
 class ProcessScheduler
@@ -19,17 +24,66 @@ class ProcessScheduler
 private:
     int schedulerInt;
     vector<PCB *> process;
-    std::mt19937 rng{std::random_device{}()};
+    uint64_t seed; // Semente mestre (simulation.seed)
+    std::mt19937 rng;
+    std::mutex rngMutex; // Núcleos escalonam em paralelo (filas locais)
+
+    // MLFQ (algoritmo 5)
+    std::shared_ptr<MlfqState> mlfq = std::make_shared<MlfqState>();
+    int mlfqBoostInterval = 0;
+    uint64_t mlfqCompletedSlices = 0;
+    uint64_t mlfqBoosts = 0;
+
+    // CFS (algoritmo 6)
+    std::shared_ptr<CfsState> cfs = std::make_shared<CfsState>();
+
+    // Tempo real (EDF = 7, RM = 8)
+    int realtimeJobs = 4;
+    int realtimeQuantum = 16;
+
+    int seededQuantum(size_t index) const;
+    int seededPriority(size_t index) const;
 
 public:
-    ProcessScheduler(int scaler, vector<PCB *> process);
+    ProcessScheduler(int scaler, vector<PCB *> process, uint64_t seed);
 
-    PCB *scheduler(vector<PCB *> process);
-    PCB *first_come_first_served(vector<PCB *> process);
-    PCB *shortest_job_first(vector<PCB *> process);
-    PCB *round_robin(vector<PCB *> process);
-    PCB *priority(vector<PCB *> process);
+    PCB *scheduler(const vector<PCB *> &process);
+    PCB *first_come_first_served(const vector<PCB *> &process);
+    PCB *shortest_job_first(const vector<PCB *> &process);
+    PCB *round_robin(const vector<PCB *> &process);
+    PCB *priority(const vector<PCB *> &process);
     PCB *lotterySelect(const std::vector<PCB *> &readyQueue);
+
+    // Registra um processo que chegou durante a simulação (carga aberta)
+    void admit(PCB *process);
+
+    // Estrutura de prontos indexada da política (usada pelas filas dos núcleos)
+    std::unique_ptr<ReadyQueue> makeReadyQueue(std::size_t coreId) const;
+
+    // MLFQ: níveis, quantum por nível e intervalo de boost (em fatias concluídas)
+    void configureMlfq(int levels, const std::vector<int> &quanta, int boostInterval);
+    // Contabilidade ao fim de cada fatia. MLFQ: rebaixa quem esgotou o quantum,
+    // promove quem bloqueou por I/O e dispara o boost periódico. CFS: cobra a
+    // fatia no vruntime, seja qual for o núcleo em que ela rodou.
+    void onSliceEnd(PCB &process);
+    int getMlfqLevels() const { return mlfq->levels; }
+    int getMlfqQuantum(int level) const { return mlfq->quanta.at(level); }
+    uint64_t getMlfqBoosts() const { return mlfqBoosts; }
+
+    // CFS: latência alvo e granularidade mínima, em ciclos
+    void configureCfs(int targetLatency, int minGranularity);
+    int getAlgorithm() const { return schedulerInt; }
+
+    // Tempo real: quantum fixo (ponto de reavaliação do EDF/RM) e número de
+    // jobs das tarefas periódicas que não definem 'jobs' no metadata
+    void configureRealtime(int quantum, int jobs);
+    // Fecha o job atual (atraso, deadline perdido) e, se ainda houver jobs,
+    // libera o próximo: PC volta ao início e o deadline avança um período.
+    // Retorna false quando a tarefa terminou todos os jobs.
+    bool releaseNextJob(PCB &process);
+
+    // Peso do processo na divisão da CPU (CFS usa a prioridade; demais políticas, 1)
+    double shareWeight(const PCB &process) const;
     void setQuantum();
     void setTimeStamp();
     void setPriority();
@@ -0,0 +1,442 @@
+#include "readyQueue.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "../cpu/PCB.hpp"
+
+// ===================== FCFS / Round-Robin =====================
+
+void FifoReadyQueue::push(PCB *process) {
+    items.push_back(process);
+}
+
+PCB *FifoReadyQueue::pop() {
+    if (items.empty()) {
+        return nullptr;
+    }
+    PCB *process = items.front();
+    items.pop_front();
+    return process;
+}
+
+PCB *FifoReadyQueue::steal() {
+    if (items.empty()) {
+        return nullptr;
+    }
+    PCB *process = items.back();
+    items.pop_back();
+    return process;
+}
+
+std::size_t FifoReadyQueue::size() const {
+    return items.size();
+}
+
+// ===================== SJF =====================
+
+// Comparador do heap: 'a' sai depois de 'b'
+bool SjfReadyQueue::later(const Entry &a, const Entry &b) {
+    if (a.instructions != b.instructions) {
+        return a.instructions > b.instructions;
+    }
+    return a.seq > b.seq;
+}
+
+void SjfReadyQueue::push(PCB *process) {
+    heap.push_back({process->instructions, nextSeq++, process});
+    std::push_heap(heap.begin(), heap.end(), later);
+}
+
+PCB *SjfReadyQueue::pop() {
+    if (heap.empty()) {
+        return nullptr;
+    }
+    std::pop_heap(heap.begin(), heap.end(), later);
+    PCB *process = heap.back().process;
+    heap.pop_back();
+    return process;
+}
+
+// Remover a última posição do vetor mantém a propriedade do heap, e ela
+// sempre é uma folha (um dos jobs mais longos)
+PCB *SjfReadyQueue::steal() {
+    if (heap.empty()) {
+        return nullptr;
+    }
+    PCB *process = heap.back().process;
+    heap.pop_back();
+    return process;
+}
+
+std::size_t SjfReadyQueue::size() const {
+    return heap.size();
+}
+
+// ===================== Priority =====================
+
+int PriorityReadyQueue::levelOf(const PCB *process) {
+    return std::clamp(process->priority, 0, LEVELS - 1);
+}
+
+void PriorityReadyQueue::push(PCB *process) {
+    int level = levelOf(process);
+    levels[level].push_back(process);
+    bitmap |= (uint64_t{1} << level);
+    count++;
+}
+
+PCB *PriorityReadyQueue::pop() {
+    if (bitmap == 0) {
+        return nullptr;
+    }
+    int level = __builtin_ctzll(bitmap);  // Nível não vazio mais prioritário
+    PCB *process = levels[level].front();
+    levels[level].pop_front();
+    if (levels[level].empty()) {
+        bitmap &= ~(uint64_t{1} << level);
+    }
+    count--;
+    return process;
+}
+
+PCB *PriorityReadyQueue::steal() {
+    if (bitmap == 0) {
+        return nullptr;
+    }
+    int level = 63 - __builtin_clzll(bitmap);  // Nível não vazio menos prioritário
+    PCB *process = levels[level].back();
+    levels[level].pop_back();
+    if (levels[level].empty()) {
+        bitmap &= ~(uint64_t{1} << level);
+    }
+    count--;
+    return process;
+}
+
+std::size_t PriorityReadyQueue::size() const {
+    return count;
+}
+
+// ===================== Lottery =====================
+
+LotteryReadyQueue::LotteryReadyQueue(uint64_t seed)
+    : tree(1, 0), rng(static_cast<std::mt19937::result_type>(seed)) {}
+
+// Dobra a capacidade e reconstrói a árvore em O(n)
+void LotteryReadyQueue::grow() {
+    std::size_t oldCapacity = slots.size();
+    std::size_t newCapacity = std::max<std::size_t>(16, oldCapacity * 2);
+
+    slots.resize(newCapacity, nullptr);
+    tickets.resize(newCapacity, 0);
+    for (std::size_t slot = newCapacity; slot-- > oldCapacity;) {
+        freeSlots.push_back(slot);
+    }
+
+    tree.assign(newCapacity + 1, 0);
+    for (std::size_t i = 1; i <= newCapacity; ++i) {
+        tree[i] += tickets[i - 1];
+        std::size_t parent = i + (i & (~i + 1));
+        if (parent <= newCapacity) {
+            tree[parent] += tree[i];
+        }
+    }
+}
+
+void LotteryReadyQueue::add(std::size_t slot, int64_t delta) {
+    for (std::size_t i = slot + 1; i < tree.size(); i += i & (~i + 1)) {
+        tree[i] += delta;
+    }
+}
+
+int64_t LotteryReadyQueue::total() const {
+    int64_t sum = 0;
+    for (std::size_t i = tree.size() - 1; i > 0; i -= i & (~i + 1)) {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+std::size_t LotteryReadyQueue::find(int64_t ticket) const {
+    std::size_t pos = 0;
+    std::size_t step = 1;
+    while ((step << 1) < tree.size()) {
+        step <<= 1;
+    }
+    for (; step > 0; step >>= 1) {
+        if (pos + step < tree.size() && tree[pos + step] < ticket) {
+            pos += step;
+            ticket -= tree[pos];
+        }
+    }
+    return pos;  // slot 0-based = índice Fenwick - 1
+}
+
+PCB *LotteryReadyQueue::removeSlot(std::size_t slot) {
+    PCB *process = slots[slot];
+    add(slot, -tickets[slot]);
+    tickets[slot] = 0;
+    slots[slot] = nullptr;
+    freeSlots.push_back(slot);
+    count--;
+    return process;
+}
+
+void LotteryReadyQueue::push(PCB *process) {
+    if (freeSlots.empty()) {
+        grow();
+    }
+    std::size_t slot = freeSlots.back();
+    freeSlots.pop_back();
+
+    slots[slot] = process;
+    tickets[slot] = std::max(1, process->tickets);
+    add(slot, tickets[slot]);
+    count++;
+}
+
+PCB *LotteryReadyQueue::pop() {
+    if (count == 0) {
+        return nullptr;
+    }
+    std::uniform_int_distribution<int64_t> dist(1, total());
+    return removeSlot(find(dist(rng)));
+}
+
+// Quem rouba também sorteia: nenhum processo é sempre o último da loteria
+PCB *LotteryReadyQueue::steal() {
+    return pop();
+}
+
+std::size_t LotteryReadyQueue::size() const {
+    return count;
+}
+
+// ===================== MLFQ =====================
+
+MlfqReadyQueue::MlfqReadyQueue(std::shared_ptr<MlfqState> state)
+    : state(std::move(state)),
+      levels(this->state->levels) {}
+
+void MlfqReadyQueue::push(PCB *process) {
+    applyPendingBoost();
+
+    int level = std::clamp(process->mlfqLevel.load(), 0, state->levels - 1);
+    process->mlfqStats().readySince = std::chrono::steady_clock::now();
+    levels[level].push_back(process);
+    bitmap |= (1u << level);
+    count++;
+}
+
+// Um boost ocorrido desde a última operação sobe tudo para o nível 0,
+// mantendo a ordem (níveis mais altos primeiro)
+void MlfqReadyQueue::applyPendingBoost() {
+    uint64_t epoch = state->boostEpoch.load();
+    if (epoch == seenBoostEpoch) {
+        return;
+    }
+    seenBoostEpoch = epoch;
+
+    for (int level = 1; level < state->levels; ++level) {
+        for (PCB *process : levels[level]) {
+            levels[0].push_back(process);
+        }
+        levels[level].clear();
+    }
+    bitmap = levels[0].empty() ? 0 : 1u;
+}
+
+PCB *MlfqReadyQueue::removeFrom(int level, bool front) {
+    PCB *process = nullptr;
+    if (front) {
+        process = levels[level].front();
+        levels[level].pop_front();
+    } else {
+        process = levels[level].back();
+        levels[level].pop_back();
+    }
+    if (levels[level].empty()) {
+        bitmap &= ~(1u << level);
+    }
+    count--;
+
+    // O quantum e as métricas usam o nível em que o processo esperou
+    MlfqStats &stats = process->mlfqStats();
+    auto waited = std::chrono::steady_clock::now() - stats.readySince;
+    process->mlfqLevel.store(level);
+    process->mlfqSliceLevel = level;
+    process->sliceStart = process->timeStamp;
+    process->quantum = state->quanta[level];
+    stats.waitNs[level].fetch_add(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count()));
+    return process;
+}
+
+PCB *MlfqReadyQueue::pop() {
+    applyPendingBoost();
+    if (bitmap == 0) {
+        return nullptr;
+    }
+    return removeFrom(__builtin_ctz(bitmap), true);
+}
+
+PCB *MlfqReadyQueue::steal() {
+    applyPendingBoost();
+    if (bitmap == 0) {
+        return nullptr;
+    }
+    return removeFrom(31 - __builtin_clz(bitmap), false);
+}
+
+std::size_t MlfqReadyQueue::size() const {
+    return count;
+}
+
+// ===================== CFS =====================
+
+int cfsWeight(int priority) {
+    // sched_prio_to_weight do Linux, nice -20 .. 19
+    static const int weights[40] = {
+        88761, 71755, 56483, 46273, 36291,
+        29154, 23254, 18705, 14949, 11916,
+        9548,  7620,  6100,  4904,  3906,
+        3121,  2501,  1991,  1586,  1277,
+        1024,  820,   655,   526,   423,
+        335,   272,   215,   172,   137,
+        110,   87,    70,    56,    45,
+        36,    29,    23,    18,    15,
+    };
+    return weights[std::clamp(priority, -20, 19) + 20];
+}
+
+uint64_t cfsVruntimeDelta(uint64_t cycles, int weight) {
+    return (cycles << CFS_VRUNTIME_SHIFT) * CFS_NICE0_WEIGHT / static_cast<uint64_t>(std::max(1, weight));
+}
+
+CfsReadyQueue::CfsReadyQueue(std::shared_ptr<CfsState> state)
+    : state(std::move(state)) {}
+
+void CfsReadyQueue::push(PCB *process) {
+    // Processo novo ou que acordou não pode ficar muito atrás dos demais,
+    // senão monopolizaria a CPU até "alcançar" o min_vruntime
+    uint64_t floor = state->minVruntime.load();
+    uint64_t bonus = cfsVruntimeDelta(state->targetLatency / 2, CFS_NICE0_WEIGHT);
+    floor = floor > bonus ? floor - bonus : 0;
+
+    uint64_t vruntime = std::max(process->vruntime.load(), floor);
+    process->vruntime.store(vruntime);
+
+    tree.emplace(vruntime, nextSeq++, process);
+    totalWeight += cfsWeight(process->priority);
+}
+
+PCB *CfsReadyQueue::remove(std::set<Key>::iterator it, bool advanceMin) {
+    PCB *process = std::get<2>(*it);
+    uint64_t vruntime = std::get<0>(*it);
+    tree.erase(it);
+
+    int weight = cfsWeight(process->priority);
+    uint64_t runnableWeight = totalWeight;  // Inclui o próprio processo
+    totalWeight -= weight;
+
+    // Fatia dinâmica: latência alvo dividida pelos pesos, com granularidade mínima
+    uint64_t slice = state->targetLatency * weight / std::max<uint64_t>(1, runnableWeight);
+    slice = std::max(slice, state->minGranularity);
+    process->quantum = static_cast<int>(slice);
+    process->sliceStart = process->timeStamp;
+
+    // O processo mais à esquerda define o novo min_vruntime (nunca retrocede)
+    if (advanceMin) {
+        uint64_t current = state->minVruntime.load();
+        while (vruntime > current && !state->minVruntime.compare_exchange_weak(current, vruntime)) {
+        }
+    }
+    return process;
+}
+
+PCB *CfsReadyQueue::pop() {
+    if (tree.empty()) {
+        return nullptr;
+    }
+    return remove(tree.begin(), true);
+}
+
+// Quem rouba leva o processo mais adiantado (maior vruntime)
+PCB *CfsReadyQueue::steal() {
+    if (tree.empty()) {
+        return nullptr;
+    }
+    return remove(std::prev(tree.end()), false);
+}
+
+std::size_t CfsReadyQueue::size() const {
+    return tree.size();
+}
+
+// ===================== EDF / RM =====================
+
+RealtimeReadyQueue::RealtimeReadyQueue(Mode mode)
+    : mode(mode) {}
+
+bool RealtimeReadyQueue::later(const Entry &a, const Entry &b) {
+    if (a.key != b.key) {
+        return a.key > b.key;
+    }
+    return a.seq > b.seq;
+}
+
+// A chave é calculada na entrada: o deadline só muda quando um novo job é
+// liberado, e o processo sempre passa pela fila nesse momento
+void RealtimeReadyQueue::push(PCB *process) {
+    uint64_t key = std::numeric_limits<uint64_t>::max();
+    if (process->isPeriodic()) {
+        key = (mode == Mode::EDF) ? process->rt->absoluteDeadline : process->rt->rtPeriod;
+    }
+    heap.push_back({key, nextSeq++, process});
+    std::push_heap(heap.begin(), heap.end(), later);
+}
+
+PCB *RealtimeReadyQueue::pop() {
+    if (heap.empty()) {
+        return nullptr;
+    }
+    std::pop_heap(heap.begin(), heap.end(), later);
+    PCB *process = heap.back().process;
+    heap.pop_back();
+    return process;
+}
+
+// Como no SJF, a última posição é uma folha (um dos deadlines mais distantes)
+PCB *RealtimeReadyQueue::steal() {
+    if (heap.empty()) {
+        return nullptr;
+    }
+    PCB *process = heap.back().process;
+    heap.pop_back();
+    return process;
+}
+
+std::size_t RealtimeReadyQueue::size() const {
+    return heap.size();
+}
+
+// ===================== Fábrica =====================
+
+std::unique_ptr<ReadyQueue> makeReadyQueue(int algorithm, uint64_t seed) {
+    switch (algorithm) {
+        case 1:
+            return std::make_unique<SjfReadyQueue>();
+        case 2:
+            return std::make_unique<LotteryReadyQueue>(seed);
+        case 3:
+            return std::make_unique<PriorityReadyQueue>();
+        case 7:
+            return std::make_unique<RealtimeReadyQueue>(RealtimeReadyQueue::Mode::EDF);
+        case 8:
+            return std::make_unique<RealtimeReadyQueue>(RealtimeReadyQueue::Mode::RM);
+        default:
+            // Round-Robin (0) e FCFS (demais valores)
+            return std::make_unique<FifoReadyQueue>();
+    }
+}
@@ -0,0 +1,219 @@
+#ifndef READY_QUEUE_HPP
+#define READY_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <random>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+struct PCB;
+
+/*
+  Estruturas de prontos indexadas por política. Cada política guarda os
+  processos na estrutura que torna a escolha barata, em vez de varrer (e
+  copiar) um vector a cada decisão:
+
+    FCFS / Round-Robin -> deque                       O(1)
+    SJF                -> min-heap por instruções     O(log n)
+    Priority           -> bitmap + FIFO por nível     O(1)
+    Lottery            -> árvore de Fenwick (bilhetes) O(log n)
+    MLFQ               -> bitmap + FIFO por nível     O(1)
+    CFS                -> árvore ordenada por vruntime O(log n)
+    EDF / RM           -> min-heap por deadline/período O(log n)
+
+  pop() devolve o processo que a política executaria agora; steal() devolve o
+  que ela executaria por último (usado por núcleos ociosos ao roubar trabalho).
+*/
+
+class ReadyQueue {
+   public:
+    virtual ~ReadyQueue() = default;
+
+    virtual void push(PCB *process) = 0;
+    virtual PCB *pop() = 0;
+    virtual PCB *steal() = 0;
+    virtual std::size_t size() const = 0;
+
+    bool empty() const { return size() == 0; }
+};
+
+// FCFS e Round-Robin: ordem de chegada
+class FifoReadyQueue : public ReadyQueue {
+   public:
+    void push(PCB *process) override;
+    PCB *pop() override;
+    PCB *steal() override;
+    std::size_t size() const override;
+
+   private:
+    std::deque<PCB *> items;
+};
+
+// SJF: menor número de instruções primeiro; empate pela ordem de chegada
+class SjfReadyQueue : public ReadyQueue {
+   public:
+    void push(PCB *process) override;
+    PCB *pop() override;
+    PCB *steal() override;
+    std::size_t size() const override;
+
+   private:
+    struct Entry {
+        int instructions;
+        uint64_t seq;
+        PCB *process;
+    };
+    static bool later(const Entry &a, const Entry &b);
+
+    std::vector<Entry> heap;
+    uint64_t nextSeq = 0;
+};
+
+// Priority: menor valor = mais prioritário; um bit por nível não vazio
+class PriorityReadyQueue : public ReadyQueue {
+   public:
+    static constexpr int LEVELS = 64;
+
+    void push(PCB *process) override;
+    PCB *pop() override;
+    PCB *steal() override;
+    std::size_t size() const override;
+
+   private:
+    static int levelOf(const PCB *process);
+
+    std::array<std::deque<PCB *>, LEVELS> levels;
+    uint64_t bitmap = 0;
+    std::size_t count = 0;
+};
+
+// Lottery: sorteio proporcional aos bilhetes; prefixos na árvore de Fenwick
+class LotteryReadyQueue : public ReadyQueue {
+   public:
+    explicit LotteryReadyQueue(uint64_t seed);
+
+    void push(PCB *process) override;
+    PCB *pop() override;
+    PCB *steal() override;
+    std::size_t size() const override;
+
+   private:
+    void grow();
+    void add(std::size_t slot, int64_t delta);
+    int64_t total() const;
+    std::size_t find(int64_t ticket) const;  // Menor slot com prefixo >= ticket
+    PCB *removeSlot(std::size_t slot);
+
+    std::vector<int64_t> tree;     // Fenwick, índice 1..capacidade
+    std::vector<PCB *> slots;      // Processo em cada slot (0-based)
+    std::vector<int64_t> tickets;  // Bilhetes de cada slot
+    std::vector<std::size_t> freeSlots;
+    std::size_t count = 0;
+    std::mt19937 rng;
+};
+
+// Parâmetros da MLFQ compartilhados pelas filas de todos os núcleos
+struct MlfqState {
+    int levels = 3;
+    std::vector<int> quanta;             // Quantum de cada nível
+    std::atomic<uint64_t> boostEpoch{0}; // Incrementado a cada boost de prioridade
+};
+
+// MLFQ: nível 0 primeiro; o processo recebe o quantum do nível ao sair da fila.
+// Depois de um boost, as entradas que estavam em níveis baixos sobem para o 0.
+class MlfqReadyQueue : public ReadyQueue {
+   public:
+    explicit MlfqReadyQueue(std::shared_ptr<MlfqState> state);
+
+    void push(PCB *process) override;
+    PCB *pop() override;
+    PCB *steal() override;
+    std::size_t size() const override;
+
+   private:
+    void applyPendingBoost();
+    PCB *removeFrom(int level, bool front);
+
+    std::shared_ptr<MlfqState> state;
+    std::vector<std::deque<PCB *>> levels;
+    uint32_t bitmap = 0;
+    std::size_t count = 0;
+    uint64_t seenBoostEpoch = 0;
+};
+
+// Parâmetros do CFS compartilhados pelas filas de todos os núcleos
+constexpr int CFS_NICE0_WEIGHT = 1024;
+constexpr int CFS_VRUNTIME_SHIFT = 10;  // vruntime em 1/1024 de ciclo
+
+struct CfsState {
+    uint64_t targetLatency = 48;          // Período em que todos os prontos devem rodar (ciclos)
+    uint64_t minGranularity = 6;          // Fatia mínima (ciclos)
+    std::atomic<uint64_t> minVruntime{0}; // Cresce de forma monotônica
+};
+
+// Peso de um processo a partir da prioridade (tratada como nice, tabela do Linux)
+int cfsWeight(int priority);
+
+// Converte ciclos executados no avanço de vruntime de um processo com 'weight'
+uint64_t cfsVruntimeDelta(uint64_t cycles, int weight);
+
+// CFS: menor vruntime primeiro. A fatia é a parte da latência alvo
+// proporcional ao peso do processo entre os prontos da fila.
+class CfsReadyQueue : public ReadyQueue {
+   public:
+    explicit CfsReadyQueue(std::shared_ptr<CfsState> state);
+
+    void push(PCB *process) override;
+    PCB *pop() override;
+    PCB *steal() override;
+    std::size_t size() const override;
+
+   private:
+    using Key = std::tuple<uint64_t, uint64_t, PCB *>;  // (vruntime, chegada, processo)
+
+    PCB *remove(std::set<Key>::iterator it, bool advanceMin);
+
+    std::shared_ptr<CfsState> state;
+    std::set<Key> tree;  // Árvore rubro-negra
+    uint64_t totalWeight = 0;
+    uint64_t nextSeq = 0;
+};
+
+// Tempo real: EDF ordena pelo deadline absoluto do job; RM pelo período da
+// tarefa (prioridade fixa). Processos sem período vão para o fim da fila.
+class RealtimeReadyQueue : public ReadyQueue {
+   public:
+    enum class Mode { EDF, RM };
+
+    explicit RealtimeReadyQueue(Mode mode);
+
+    void push(PCB *process) override;
+    PCB *pop() override;
+    PCB *steal() override;
+    std::size_t size() const override;
+
+   private:
+    struct Entry {
+        uint64_t key;
+        uint64_t seq;
+        PCB *process;
+    };
+    static bool later(const Entry &a, const Entry &b);
+
+    Mode mode;
+    std::vector<Entry> heap;
+    uint64_t nextSeq = 0;
+};
+
+// Cria a estrutura adequada ao algoritmo (mesma numeração de scheduling.algorithm);
+// 'seed' alimenta o sorteio da loteria
+std::unique_ptr<ReadyQueue> makeReadyQueue(int algorithm, uint64_t seed);
+
+#endif
@@ -44,6 +44,7 @@ if not EXE_FULL_PATH:
     EXE_FULL_PATH = os.path.join(PROJECT_ROOT, "src", EXE_NAME)
 
 PATH_LOG = os.path.join(PROJECT_ROOT, "output", "resultados.dat")
+PATH_STATS = os.path.join(PROJECT_ROOT, "output", "stats.json")
 PATH_OUTPUT_DIR = os.path.join(PROJECT_ROOT, "output")
 
 # --- MAPAS DE LEGENDAS (Para o CSV ficar legível) ---
@@ -136,14 +137,38 @@ def compile_project():
         except: pass
 
 def run_simulation():
+    # Um retrato antigo não pode passar pelo resultado de uma execução que falhou
+    if os.path.exists(PATH_STATS): os.remove(PATH_STATS)
     try:
         subprocess.run([EXE_FULL_PATH], cwd=PROJECT_ROOT, check=True, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, timeout=5)
     except subprocess.TimeoutExpired:
         print("  [AVISO] Timeout.")
     except Exception: pass
 
+def parse_stats_file():
+    # Último retrato do registro de estatísticas (simulation.stats.file)
+    try:
+        with open(PATH_STATS, 'r', encoding='utf-8') as f: dumps = json.load(f).get("dumps", [])
+    except (OSError, ValueError): return None
+    if not dumps: return None
+    stats_by_pid = {}
+    for pid, d in dumps[-1]["stats"].get("process", {}).items():
+        stats_by_pid[int(pid)] = {
+            'exec_time': d.get("time", {}).get("execution", 0),
+            'mem_cycles': d.get("memory_cycles", 0),
+            'cache_misses': d.get("cache", {}).get("read_misses", 0),
+        }
+    return stats_by_pid
+
 def parse_results(cores=1):
-    if not os.path.exists(PATH_LOG): return {"makespan": 0, "total_mem": 0, "misses": 0}
+    stats_by_pid = parse_stats_file()
+    if stats_by_pid is None:
+        stats_by_pid = parse_log_file()
+    if stats_by_pid is None: return {"makespan": 0, "total_mem": 0, "misses": 0}
+    return summarize_results(stats_by_pid, cores)
+
+def parse_log_file():
+    if not os.path.exists(PATH_LOG): return None
     stats_by_pid = {}
     with open(PATH_LOG, 'r', encoding='utf-8', errors='ignore') as f: content = f.read()
     
@@ -165,7 +190,9 @@ def parse_results(cores=1):
         
         if pid not in stats_by_pid: stats_by_pid[pid] = {}
         stats_by_pid[pid].update(metrics)
-        
+    return stats_by_pid
+
+def summarize_results(stats_by_pid, cores):
     sys_stats = {"makespan": 0, "total_mem": 0, "misses": 0}
     total_workload = 0
     
@@ -0,0 +1,72 @@
+#include "completionQueue.hpp"
+
+#include <algorithm>
+
+CompletionQueue::CompletionQueue()
+    : delivered(0),
+      wakeups(0),
+      totalLatencyNs(0),
+      maxLatencyNs(0) {}
+
+void CompletionQueue::post(CompletionEvent event) {
+    event.postedAt = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back(event);
+    }
+    cv.notify_one();
+}
+
+void CompletionQueue::postCoreIdle(std::size_t coreId, PCB *process) {
+    CompletionEvent event;
+    event.type = CompletionEventType::CORE_IDLE;
+    event.coreId = coreId;
+    event.process = process;
+    post(event);
+}
+
+void CompletionQueue::postUnblocked(PCB *process) {
+    CompletionEvent event;
+    event.type = CompletionEventType::PROCESS_UNBLOCKED;
+    event.process = process;
+    post(event);
+}
+
+std::deque<CompletionEvent> CompletionQueue::waitAll() {
+    std::deque<CompletionEvent> pending;
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return !events.empty(); });
+    pending.swap(events);
+
+    // Latência entre a publicação do evento e o despachante acordar para tratá-lo
+    auto now = std::chrono::steady_clock::now();
+    for (const auto &event : pending) {
+        uint64_t ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - event.postedAt).count());
+        totalLatencyNs += ns;
+        maxLatencyNs = std::max(maxLatencyNs, ns);
+    }
+    delivered += pending.size();
+    wakeups++;
+    return pending;
+}
+
+uint64_t CompletionQueue::getDelivered() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return delivered;
+}
+
+uint64_t CompletionQueue::getWakeups() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return wakeups;
+}
+
+double CompletionQueue::getAverageLatencyUs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return delivered ? static_cast<double>(totalLatencyNs) / delivered / 1000.0 : 0.0;
+}
+
+double CompletionQueue::getMaxLatencyUs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<double>(maxLatencyNs) / 1000.0;
+}
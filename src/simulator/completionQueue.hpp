@@ -0,0 +1,62 @@
+#ifndef COMPLETION_QUEUE_HPP
+#define COMPLETION_QUEUE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+struct PCB;
+
+/*
+  Fila de conclusões do despachante. Os núcleos (fim de uma fatia de execução)
+  e o IOManager (fim de I/O ou de um page fault) publicam eventos aqui, e o
+  laço principal do simulador dorme na fila até o próximo evento em vez de
+  acordar periodicamente para verificar o estado de cada núcleo.
+*/
+
+enum class CompletionEventType {
+    CORE_IDLE,          // Núcleo terminou a fatia de 'process'
+    PROCESS_UNBLOCKED   // Processo bloqueado voltou a ficar pronto
+};
+
+struct CompletionEvent {
+    CompletionEventType type = CompletionEventType::CORE_IDLE;
+    std::size_t coreId = 0;    // Válido em CORE_IDLE
+    PCB *process = nullptr;
+    std::chrono::steady_clock::time_point postedAt{};
+};
+
+class CompletionQueue {
+   private:
+    std::deque<CompletionEvent> events;
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+
+    // Estatísticas do despachante
+    uint64_t delivered;
+    uint64_t wakeups;
+    uint64_t totalLatencyNs;
+    uint64_t maxLatencyNs;
+
+   public:
+    CompletionQueue();
+
+    void postCoreIdle(std::size_t coreId, PCB *process);
+    void postUnblocked(PCB *process);
+
+    // Bloqueia até existir ao menos um evento e devolve todos os pendentes
+    std::deque<CompletionEvent> waitAll();
+
+    uint64_t getDelivered() const;
+    uint64_t getWakeups() const;
+    double getAverageLatencyUs() const;
+    double getMaxLatencyUs() const;
+
+   private:
+    void post(CompletionEvent event);
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include "eventTimeline.hpp"
+
+#include <algorithm>
+
+// Comparador do heap: 'a' sai depois de 'b'
+bool EventTimeline::later(const SimEvent &a, const SimEvent &b) {
+    if (a.time != b.time) {
+        return a.time > b.time;
+    }
+    return a.seq > b.seq;
+}
+
+void EventTimeline::schedule(uint64_t time, SimEventType type, PCB *process) {
+    heap.push_back({time, nextSeq++, type, process});
+    std::push_heap(heap.begin(), heap.end(), later);
+}
+
+bool EventTimeline::empty() const {
+    return heap.empty();
+}
+
+std::size_t EventTimeline::size() const {
+    return heap.size();
+}
+
+uint64_t EventTimeline::nextTime() const {
+    return heap.front().time;
+}
+
+SimEvent EventTimeline::pop() {
+    std::pop_heap(heap.begin(), heap.end(), later);
+    SimEvent event = heap.back();
+    heap.pop_back();
+
+    // O relógio global nunca retrocede
+    clock = std::max(clock, event.time);
+    processed++;
+    processedByType[static_cast<std::size_t>(event.type)]++;
+    return event;
+}
+
+uint64_t EventTimeline::now() const {
+    return clock;
+}
+
+uint64_t EventTimeline::getProcessed() const {
+    return processed;
+}
+
+uint64_t EventTimeline::getProcessed(SimEventType type) const {
+    return processedByType[static_cast<std::size_t>(type)];
+}
@@ -0,0 +1,66 @@
+#ifndef EVENT_TIMELINE_HPP
+#define EVENT_TIMELINE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct PCB;
+
+/*
+  Linha do tempo simulada (simulação de eventos discretos). Cada evento marca
+  o instante, em ciclos, em que um processo fica pronto: chegada, fim de uma
+  fatia, fim de I/O ou de swap-in e liberação de um job periódico. O
+  despachante entrega os processos aos núcleos na ordem desses instantes, e o
+  relógio global avança para o instante de cada evento retirado.
+
+  Os núcleos executam em paralelo no hospedeiro, cada um com o próprio relógio
+  local; a fatia de um processo começa em max(relógio do núcleo, instante em
+  que o processo ficou pronto).
+*/
+
+enum class SimEventType {
+    ARRIVAL,           // Processo chegou ao sistema
+    SLICE_END,         // Fatia terminou (quantum ou preempção) e o processo voltou a ficar pronto
+    IO_COMPLETE,       // Fim de uma operação de dispositivo
+    PAGE_IN_COMPLETE,  // Fim do swap-in de um page fault assíncrono
+    JOB_RELEASE,       // Próximo job de uma tarefa periódica
+    ADMISSION,         // Chegada que esperava vaga no grau de multiprogramação
+    COUNT
+};
+
+struct SimEvent {
+    uint64_t time = 0;  // Instante simulado (ciclos)
+    uint64_t seq = 0;   // Desempate: ordem de agendamento
+    SimEventType type = SimEventType::ARRIVAL;
+    PCB *process = nullptr;
+};
+
+// Usada apenas pela thread do despachante
+class EventTimeline {
+   public:
+    void schedule(uint64_t time, SimEventType type, PCB *process);
+
+    bool empty() const;
+    std::size_t size() const;
+    uint64_t nextTime() const;  // Instante do próximo evento (fila não vazia)
+
+    // Remove o próximo evento e avança o relógio global até ele
+    SimEvent pop();
+
+    uint64_t now() const;
+    uint64_t getProcessed() const;
+    uint64_t getProcessed(SimEventType type) const;
+
+   private:
+    static bool later(const SimEvent &a, const SimEvent &b);
+
+    std::vector<SimEvent> heap;
+    uint64_t clock = 0;
+    uint64_t nextSeq = 0;
+    uint64_t processed = 0;
+    std::array<uint64_t, static_cast<std::size_t>(SimEventType::COUNT)> processedByType{};
+};
+
+#endif
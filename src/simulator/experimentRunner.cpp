@@ -0,0 +1,246 @@
+#include "experimentRunner.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <thread>
+
+namespace {
+// Descarta o que os simuladores escrevem em std::cout durante o lote
+class NullBuffer : public std::streambuf {
+   protected:
+    int overflow(int c) override {
+        return c;
+    }
+};
+
+json readJson(const std::string &path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Erro: Não foi possível abrir '" + path + "'.");
+    }
+    json document;
+    file >> document;
+    return document;
+}
+
+// "cpu.cores" -> document["cpu"]["cores"] = value
+void setPath(json &document, const std::string &path, const json &value) {
+    json *node = &document;
+    std::stringstream parts(path);
+    std::string part;
+    while (std::getline(parts, part, '.')) {
+        if (!node->is_object()) {
+            throw std::runtime_error("Erro: '" + path + "' não é um parâmetro da configuração.");
+        }
+        node = &(*node)[part];
+    }
+    *node = value;
+}
+
+std::string cell(const json &value) {
+    return value.is_string() ? value.get<std::string>() : value.dump();
+}
+} // namespace
+
+ExperimentRunner::ExperimentRunner(const std::string &specPath) {
+    json spec = readJson(specPath);
+    baseConfig = readJson(spec.value("base_config", std::string("src/system_config/system_config.json")));
+    grid = spec.value("grid", json::object());
+    threads = spec.value("threads", 0);
+    repetitions = std::max(1, spec.value("repetitions", 1));
+    outputPath = spec.value("output", std::string("output/experiments.csv"));
+}
+
+// Produto cartesiano da grade; a última chave varia mais rápido
+void ExperimentRunner::expandGrid() {
+    std::vector<json> values;
+    for (const auto &[key, options] : grid.items()) {
+        keys.push_back(key);
+        values.push_back(options.is_array() ? options : json::array({options}));
+        if (values.back().empty()) {
+            throw std::runtime_error("Erro: a grade de '" + key + "' está vazia.");
+        }
+    }
+
+    std::vector<std::size_t> index(keys.size(), 0);
+    while (true) {
+        json settings = json::object();
+        json document = baseConfig;
+        for (std::size_t k = 0; k < keys.size(); ++k) {
+            settings[keys[k]] = values[k][index[k]];
+            setPath(document, keys[k], values[k][index[k]]);
+        }
+        // As repetições de um ponto compartilham a mesma configuração
+        auto config = std::make_shared<const SystemConfig>(SystemConfig::fromJson(document));
+        for (int r = 0; r < repetitions; ++r) {
+            Experiment experiment;
+            experiment.id = experiments.size();
+            experiment.repetition = r;
+            experiment.settings = settings;
+            experiment.config = config;
+            experiments.push_back(std::move(experiment));
+        }
+
+        std::size_t k = keys.size();
+        while (k > 0 && ++index[k - 1] == values[k - 1].size()) {
+            index[k - 1] = 0;
+            --k;
+        }
+        if (k == 0) {
+            break;
+        }
+    }
+}
+
+// Monta os programas uma vez, em paralelo; as execuções só instalam as imagens
+void ExperimentRunner::loadPrograms() {
+    std::vector<std::string> files;
+    for (const auto &entry : std::filesystem::directory_iterator("src/tasks")) {
+        if (entry.is_regular_file() && isProgramSource(entry.path().string())) {
+            files.push_back(entry.path().string());
+        }
+    }
+
+    auto cache = std::make_shared<ProgramCache>();
+    const std::string imageCache = experiments.empty() ? std::string() : experiments.front().config->simulation.image_cache;
+    for (auto &image : assembleProgramFiles(files, threads > 0 ? static_cast<unsigned>(threads) : 0, imageCache)) {
+        std::string source = image.source;
+        (*cache)[source] = std::move(image);
+    }
+    programs = cache;
+}
+
+void ExperimentRunner::runExperiment(Experiment &experiment) const {
+    try {
+        Simulator simulator(*experiment.config, programs);
+        experiment.ok = simulator.run() == 0;
+        experiment.summary = simulator.getSummary();
+        if (!experiment.ok) {
+            experiment.error = "falha ao carregar as tasks";
+        }
+    } catch (const std::exception &ex) {
+        experiment.error = ex.what();
+    }
+}
+
+int ExperimentRunner::run() {
+    expandGrid();
+    loadPrograms();
+
+    unsigned workers = threads > 0 ? static_cast<unsigned>(threads) : std::thread::hardware_concurrency();
+    workers = std::max(1u, std::min<unsigned>(workers, static_cast<unsigned>(experiments.size())));
+
+    std::ostream console(std::cout.rdbuf());
+    console << "Lote: " << experiments.size() << " execuções (" << experiments.size() / repetitions
+            << " pontos x " << repetitions << " repetições) em " << workers << " threads\n";
+
+    NullBuffer discard;
+    std::streambuf *original = std::cout.rdbuf(&discard);
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> done{0};
+    std::mutex consoleMutex;
+    std::vector<std::thread> pool;
+    for (unsigned w = 0; w < workers; ++w) {
+        pool.emplace_back([&]() {
+            for (std::size_t i = next++; i < experiments.size(); i = next++) {
+                runExperiment(experiments[i]);
+                std::lock_guard<std::mutex> lock(consoleMutex);
+                console << "[" << ++done << "/" << experiments.size() << "] " << experiments[i].settings.dump()
+                        << " rep " << experiments[i].repetition << ": "
+                        << (experiments[i].ok ? "ok" : experiments[i].error) << "\n";
+            }
+        });
+    }
+    for (auto &worker : pool) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout.rdbuf(original);
+
+    std::filesystem::path output(outputPath);
+    if (output.has_parent_path()) {
+        std::filesystem::create_directories(output.parent_path());
+    }
+    if (output.extension() == ".json") {
+        writeJson();
+    } else {
+        writeCsv();
+    }
+
+    std::size_t failed = 0;
+    for (const auto &experiment : experiments) {
+        failed += experiment.ok ? 0 : 1;
+    }
+    std::cout << "Lote concluído em " << elapsed.count() << " s | " << failed << " falhas | resultados em "
+              << outputPath << "\n";
+    return failed == 0 ? 0 : 1;
+}
+
+void ExperimentRunner::writeCsv() const {
+    std::ofstream file(outputPath);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir arquivo para salvar o lote: " << outputPath << "\n";
+        return;
+    }
+
+    file << "Run,Repetition";
+    for (const auto &key : keys) {
+        file << "," << key;
+    }
+    file << ",Processes,SimulatedCycles,AvgWaiting,AvgTurnaround,AvgResponse,CpuUtilization,"
+            "ThroughputPer1000,CacheHitRate,Migrations,DeadlineMisses,JainIndex,WallSeconds,Status\n";
+
+    for (const auto &experiment : experiments) {
+        const RunSummary &s = experiment.summary;
+        file << experiment.id << "," << experiment.repetition;
+        for (const auto &key : keys) {
+            file << "," << cell(experiment.settings.at(key));
+        }
+        file << "," << s.processes << "," << s.simulatedCycles << "," << s.avgWaiting << ","
+             << s.avgTurnaround << "," << s.avgResponse << "," << s.cpuUtilization << ","
+             << s.throughput << "," << s.cacheHitRate << "," << s.migrations << ","
+             << s.deadlineMisses << "," << s.jainIndex << "," << s.wallSeconds << ","
+             << (experiment.ok ? "ok" : experiment.error) << "\n";
+    }
+}
+
+void ExperimentRunner::writeJson() const {
+    json rows = json::array();
+    for (const auto &experiment : experiments) {
+        const RunSummary &s = experiment.summary;
+        rows.push_back({
+            {"run", experiment.id},
+            {"repetition", experiment.repetition},
+            {"settings", experiment.settings},
+            {"status", experiment.ok ? "ok" : experiment.error},
+            {"processes", s.processes},
+            {"simulated_cycles", s.simulatedCycles},
+            {"avg_waiting", s.avgWaiting},
+            {"avg_turnaround", s.avgTurnaround},
+            {"avg_response", s.avgResponse},
+            {"cpu_utilization", s.cpuUtilization},
+            {"throughput_per_1000", s.throughput},
+            {"cache_hit_rate", s.cacheHitRate},
+            {"migrations", s.migrations},
+            {"deadline_misses", s.deadlineMisses},
+            {"jain_index", s.jainIndex},
+            {"wall_seconds", s.wallSeconds},
+        });
+    }
+
+    std::ofstream file(outputPath);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir arquivo para salvar o lote: " << outputPath << "\n";
+        return;
+    }
+    file << rows.dump(4) << "\n";
+}
@@ -0,0 +1,66 @@
+#ifndef EXPERIMENT_RUNNER_HPP
+#define EXPERIMENT_RUNNER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "simulator.hpp"
+
+/*
+  Lote de experimentos: varre uma grade de parâmetros da configuração e roda
+  cada ponto como um Simulator independente, vários ao mesmo tempo em um pool
+  de threads dentro do mesmo processo. A configuração base e os programas de
+  src/tasks são lidos uma única vez; cada ponto altera apenas a sua cópia do
+  documento. Os resultados saem de RunSummary direto para uma tabela CSV ou
+  JSON, sem reescrever arquivos nem ler a saída de texto.
+
+  Especificação (JSON):
+    {
+        "base_config": "src/system_config/system_config.json",
+        "threads": 0,              // 0 = núcleos do hospedeiro
+        "repetitions": 1,          // Execuções de cada ponto da grade
+        "output": "output/experiments.csv",   // .json grava uma lista de objetos
+        "grid": {
+            "scheduling.algorithm": [0, 1, 6],
+            "cpu.cores": [1, 4]
+        }
+    }
+  As chaves da grade são caminhos com pontos dentro do system_config.json.
+*/
+
+class ExperimentRunner {
+   public:
+    explicit ExperimentRunner(const std::string &specPath);
+    int run();
+
+   private:
+    struct Experiment {
+        std::size_t id = 0;
+        int repetition = 0;
+        json settings;  // Valor de cada chave da grade neste ponto
+        std::shared_ptr<const SystemConfig> config;
+        RunSummary summary;
+        bool ok = false;
+        std::string error;
+    };
+
+    void expandGrid();
+    void loadPrograms();
+    void runExperiment(Experiment &experiment) const;
+    void writeCsv() const;
+    void writeJson() const;
+
+    json baseConfig;
+    json grid;
+    int threads = 0;
+    int repetitions = 1;
+    std::string outputPath;
+
+    std::shared_ptr<const ProgramCache> programs;
+    std::vector<std::string> keys;  // Chaves da grade, na ordem das colunas
+    std::vector<Experiment> experiments;
+};
+
+#endif
@@ -0,0 +1,259 @@
+#include "replayLog.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+const char *typeName(ReplayEventType type) {
+    switch (type) {
+        case ReplayEventType::SLICE:
+            return "SLICE";
+        case ReplayEventType::IO:
+            return "IO";
+        default:
+            return "DISPATCH";
+    }
+}
+
+bool parseType(const std::string &name, ReplayEventType &type) {
+    for (ReplayEventType candidate : {ReplayEventType::DISPATCH, ReplayEventType::SLICE, ReplayEventType::IO}) {
+        if (name == typeName(candidate)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// "# seed=42 algorithm=0 cores=4" -> valor de 'key'
+bool headerField(const std::string &line, const std::string &key, uint64_t &value) {
+    std::size_t at = line.find(key + "=");
+    if (at == std::string::npos) {
+        return false;
+    }
+    value = std::stoull(line.substr(at + key.size() + 1));
+    return true;
+}
+} // namespace
+
+bool ReplayLog::open(ReplayMode mode, const std::string &path, uint64_t seed, int algorithm, int cores) {
+    this->mode = mode;
+    this->path = path;
+    this->seed = seed;
+    this->algorithm = algorithm;
+    this->cores = cores;
+    if (mode != ReplayMode::REPLAY) {
+        return true;
+    }
+
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Erro: log de replay '" << path << "' não encontrado.\n";
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (line.empty() || line.rfind("Seq,", 0) == 0) {
+            continue;
+        }
+        if (line[0] == '#') {
+            uint64_t field = 0;
+            if (headerField(line, "seed", field)) {
+                this->seed = field;
+            }
+            if (headerField(line, "algorithm", field) && static_cast<int>(field) != algorithm) {
+                std::cerr << "Aviso: log gravado com o algoritmo " << field << ", configuração usa "
+                          << algorithm << ".\n";
+            }
+            if (headerField(line, "cores", field) && static_cast<int>(field) != cores) {
+                std::cerr << "Aviso: log gravado com " << field << " núcleos, configuração usa " << cores
+                          << ".\n";
+            }
+            continue;
+        }
+
+        std::stringstream fields(line);
+        std::string seq, type, time, pid, core, value, state;
+        ReplayEvent event;
+        if (!std::getline(fields, seq, ',') || !std::getline(fields, type, ',') ||
+            !std::getline(fields, time, ',') || !std::getline(fields, pid, ',') ||
+            !std::getline(fields, core, ',') || !std::getline(fields, value, ',') ||
+            !std::getline(fields, state, ',') || !parseType(type, event.type)) {
+            std::cerr << "Aviso: " << path << ":" << lineNumber << ": linha ignorada.\n";
+            continue;
+        }
+        event.seq = std::stoull(seq);
+        event.time = std::stoull(time);
+        event.pid = std::stoi(pid);
+        event.core = std::stoi(core);
+        event.value = std::stoull(value);
+        event.state = std::stoi(state);
+        expected[{event.pid, event.type}].push_back(event);
+        expectedTotal++;
+    }
+    return true;
+}
+
+ReplayMode ReplayLog::getMode() const {
+    return mode;
+}
+
+uint64_t ReplayLog::getSeed() const {
+    return seed;
+}
+
+void ReplayLog::add(ReplayEvent event) {
+    event.seq = recorded.size();
+    recorded.push_back(event);
+}
+
+// Casa 'actual' com o próximo evento gravado do mesmo processo e tipo
+void ReplayLog::check(const ReplayEvent &actual) {
+    checked++;
+    auto &queue = expected[{actual.pid, actual.type}];
+    bool same = false;
+    std::string expectedText = "nenhum";
+    if (!queue.empty()) {
+        const ReplayEvent &want = queue.front();
+        same = want.time == actual.time && want.core == actual.core && want.value == actual.value &&
+               want.state == actual.state;
+        expectedText = "#" + std::to_string(want.seq) + " " + describe(want);
+        queue.pop_front();
+    }
+    if (!same) {
+        if (divergences == 0) {
+            firstDivergence = describe(actual) + " (gravado: " + expectedText + ")";
+        }
+        divergences++;
+    }
+}
+
+void ReplayLog::dispatch(uint64_t time, int pid, int &core) {
+    if (mode == ReplayMode::OFF) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (mode == ReplayMode::RECORD) {
+        add({0, ReplayEventType::DISPATCH, time, pid, core, 0, 0});
+        return;
+    }
+
+    auto &queue = expected[{pid, ReplayEventType::DISPATCH}];
+    if (!queue.empty() && queue.front().core >= 0 && queue.front().core < cores) {
+        core = queue.front().core;
+    }
+    check({0, ReplayEventType::DISPATCH, time, pid, core, 0, 0});
+}
+
+void ReplayLog::sliceEnd(uint64_t time, int pid, int core, uint64_t pc, int state) {
+    if (mode == ReplayMode::OFF) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    ReplayEvent event{0, ReplayEventType::SLICE, time, pid, core, pc, state};
+    if (mode == ReplayMode::RECORD) {
+        add(event);
+    } else {
+        check(event);
+    }
+}
+
+bool ReplayLog::ioCost(int pid, uint64_t &cost) const {
+    if (mode != ReplayMode::REPLAY) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = expected.find({pid, ReplayEventType::IO});
+    if (it == expected.end() || it->second.empty()) {
+        return false;
+    }
+    cost = it->second.front().value;
+    return true;
+}
+
+void ReplayLog::ioComplete(uint64_t time, int pid, uint64_t cost) {
+    if (mode == ReplayMode::OFF) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    ReplayEvent event{0, ReplayEventType::IO, time, pid, -1, cost, 0};
+    if (mode == ReplayMode::RECORD) {
+        add(event);
+    } else {
+        check(event);
+    }
+}
+
+bool ReplayLog::save() const {
+    if (mode != ReplayMode::RECORD) {
+        return true;
+    }
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir arquivo para salvar o log de replay: " << path << "\n";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    file << "# seed=" << seed << " algorithm=" << algorithm << " cores=" << cores << "\n";
+    file << "Seq,Type,Time,PID,Core,Value,State\n";
+    for (const ReplayEvent &event : recorded) {
+        file << event.seq << "," << typeName(event.type) << "," << event.time << "," << event.pid << ","
+             << event.core << "," << event.value << "," << event.state << "\n";
+    }
+    return true;
+}
+
+void ReplayLog::printSummary() const {
+    if (mode == ReplayMode::OFF) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    std::cout << "\n==================== REPLAY ====================\n";
+    std::cout << "Semente mestre: " << seed << "\n";
+    if (mode == ReplayMode::RECORD) {
+        std::cout << "Eventos gravados: " << recorded.size() << " em " << path << "\n";
+        return;
+    }
+
+    std::size_t missing = 0;
+    for (const auto &[key, queue] : expected) {
+        missing += queue.size();
+    }
+    std::cout << "Eventos conferidos: " << checked << " de " << expectedTotal << " gravados"
+              << " | não reproduzidos: " << missing << " | divergências: " << divergences << "\n";
+    if (divergences == 0 && missing == 0) {
+        std::cout << "Execução idêntica ao log.\n";
+    } else if (divergences > 0) {
+        std::cout << "Primeira divergência: " << firstDivergence << "\n";
+    }
+}
+
+std::string ReplayLog::describe(const ReplayEvent &event) {
+    std::ostringstream text;
+    text << typeName(event.type) << " pid=" << event.pid << " t=" << event.time;
+    if (event.type != ReplayEventType::IO) {
+        text << " núcleo=" << event.core;
+    }
+    if (event.type == ReplayEventType::SLICE) {
+        text << " pc=" << event.value << " estado=" << event.state;
+    } else if (event.type == ReplayEventType::IO) {
+        text << " custo=" << event.value;
+    }
+    return text.str();
+}
+
+const char *replayModeName(ReplayMode mode) {
+    switch (mode) {
+        case ReplayMode::RECORD:
+            return "gravação";
+        case ReplayMode::REPLAY:
+            return "repetição";
+        default:
+            return "desligado";
+    }
+}
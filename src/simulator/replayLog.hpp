@@ -0,0 +1,91 @@
+#ifndef REPLAY_LOG_HPP
+#define REPLAY_LOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+  Log de eventos para gravar e repetir uma execução. Cobre as decisões que não
+  vêm do programa simulado:
+
+    DISPATCH -> instante em que o processo ficou pronto e o núcleo escolhido
+    SLICE    -> ponto de preempção: fim da fatia, PC e estado do processo
+    IO       -> fim de um I/O de dispositivo e o custo cobrado
+
+  Na gravação os eventos são escritos em ordem, com a semente mestre no
+  cabeçalho. Na repetição a semente do log substitui a da configuração, o
+  núcleo de cada despacho e o custo de cada I/O são impostos, e os demais
+  campos são conferidos. Os eventos são casados por (PID, tipo, ordem), e não
+  pela ordem global, que depende de qual núcleo termina primeiro no hospedeiro.
+  A primeira divergência aponta onde as execuções se separaram.
+*/
+
+enum class ReplayMode {
+    OFF = 0,
+    RECORD = 1,
+    REPLAY = 2
+};
+
+enum class ReplayEventType {
+    DISPATCH,
+    SLICE,
+    IO
+};
+
+struct ReplayEvent {
+    uint64_t seq = 0;
+    ReplayEventType type = ReplayEventType::DISPATCH;
+    uint64_t time = 0;
+    int pid = 0;
+    int core = -1;
+    uint64_t value = 0;  // SLICE: PC; IO: custo em ciclos
+    int state = 0;       // SLICE: estado do processo ao fim da fatia
+};
+
+class ReplayLog {
+   public:
+    // Na repetição, lê o log; false se o arquivo não puder ser lido
+    bool open(ReplayMode mode, const std::string &path, uint64_t seed, int algorithm, int cores);
+    ReplayMode getMode() const;
+    uint64_t getSeed() const;
+
+    // Gravação: registra. Repetição: impõe o núcleo gravado e confere o instante
+    void dispatch(uint64_t time, int pid, int &core);
+    void sliceEnd(uint64_t time, int pid, int core, uint64_t pc, int state);
+    // Thread do IOManager: custo gravado do próximo I/O do processo
+    bool ioCost(int pid, uint64_t &cost) const;
+    void ioComplete(uint64_t time, int pid, uint64_t cost);
+
+    // Grava o log (modo RECORD)
+    bool save() const;
+    void printSummary() const;
+
+   private:
+    void add(ReplayEvent event);
+    void check(const ReplayEvent &actual);
+    static std::string describe(const ReplayEvent &event);
+
+    ReplayMode mode = ReplayMode::OFF;
+    std::string path;
+    uint64_t seed = 0;
+    int algorithm = 0;
+    int cores = 0;
+
+    mutable std::mutex mutex;
+    std::vector<ReplayEvent> recorded;
+    std::map<std::pair<int, ReplayEventType>, std::deque<ReplayEvent>> expected;
+    std::size_t expectedTotal = 0;
+    uint64_t checked = 0;
+    uint64_t divergences = 0;
+    std::string firstDivergence;
+};
+
+const char *replayModeName(ReplayMode mode);
+
+#endif
@@ -1,6 +1,10 @@
 #include "simulator.hpp"
+#include <cmath>
+#include <limits>
+#include <set>
 #include <filesystem>
 #include <iostream>
+#include <sstream>
 
 namespace {
 std::string schedulerName(int algorithm) {
@@ -13,13 +17,73 @@ std::string schedulerName(int algorithm) {
         return "Lottery";
     case 3:
         return "Priority";
+    case 5:
+        return "MLFQ";
+    case 6:
+        return "CFS";
+    case 7:
+        return "Earliest Deadline First";
+    case 8:
+        return "Rate Monotonic";
     default:
         return "First-Come First-Served";
     }
 }
 
-bool isJsonFile(const std::filesystem::path &path) {
-    return path.extension() == ".json";
+std::string partitionModeName(CachePartitionMode mode) {
+    switch (mode) {
+    case CachePartitionMode::STATIC:
+        return "Estatico";
+    case CachePartitionMode::UTILITY:
+        return "Utilidade";
+    default:
+        return "Desligado";
+    }
+}
+
+std::string hexMask(uint64_t mask) {
+    std::ostringstream out;
+    out << "0x" << std::hex << mask;
+    return out.str();
+}
+
+const char *const MEMORY_LEVEL_NAMES[] = {"cache", "ram", "swap"};
+
+// Histogramas de todos os núcleos somados
+MemoryLatency mergedMemoryLatency(const MemoryManager &memManager, std::size_t cores) {
+    MemoryLatency total;
+    for (std::size_t core = 0; core < cores; ++core) {
+        MemoryLatency latency = memManager.getMemoryLatency(core);
+        for (std::size_t level = 0; level < total.size(); ++level) {
+            total[level].merge(latency[level]);
+        }
+    }
+    return total;
+}
+
+StatHistogram mergedDispatchWait(const std::vector<std::unique_ptr<CPUCore>> &cpuCores) {
+    StatHistogram total;
+    for (const auto &core : cpuCores) {
+        total.merge(core->getDispatchWait());
+    }
+    return total;
+}
+
+void printLatency(const std::string &label, const StatHistogram &histogram, const char *unit) {
+    std::cout << label << ": " << histogram.count() << " " << unit << " | média " << histogram.mean()
+              << " | p50 " << histogram.percentile(50) << " | p90 " << histogram.percentile(90)
+              << " | p99 " << histogram.percentile(99) << " | p99.9 " << histogram.percentile(99.9)
+              << " | máx " << histogram.max() << "\n";
+}
+
+// Percentil por posição (nearest-rank); p = 100 devolve o máximo
+uint64_t percentile(std::vector<uint64_t> values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100.0 * values.size()));
+    return values[std::clamp<std::size_t>(rank, 1, values.size()) - 1];
 }
 } // namespace
 
@@ -28,15 +92,85 @@ Simulator::Simulator(const std::string &configPath)
       memManager(config.main_memory.total, config.secondary_memory.total, config.cache.size,config.cache.line_size,config.main_memory.page_size,static_cast<PolicyType>(config.main_memory.policy)),
       ioManager() {}
 
+Simulator::Simulator(const SystemConfig &systemConfig, std::shared_ptr<const ProgramCache> programs)
+    : config(systemConfig),
+      programs(std::move(programs)),
+      writeOutputs(false),
+      memManager(config.main_memory.total, config.secondary_memory.total, config.cache.size,config.cache.line_size,config.main_memory.page_size,static_cast<PolicyType>(config.main_memory.policy)),
+      ioManager() {}
+
+const RunSummary &Simulator::getSummary() const {
+    return summary;
+}
+
 int Simulator::run() {
     std::cout << "Inicializando o simulador...\n";
     if (!loadProcesses()) {
         return 1;
     }
+    memManager.setCacheOrganization(static_cast<size_t>(std::max(0, config.cache.associativity)),
+                                    static_cast<size_t>(std::max(0, config.cache.victim_cache_size)));
     memManager.setCacheReplacementPolicy(static_cast<PolicyType>(config.cache.policy)); //onde vai chamar pra trocar a politica de substituição da cache
-    scheduler = std::make_unique<ProcessScheduler>(config.scheduling.algorithm, readyQueue);
+    memManager.setCacheWritePolicy(static_cast<WritePolicy>(config.cache.write_policy),
+                                   config.cache.write_allocate,
+                                   static_cast<size_t>(std::max(0, config.cache.write_buffer_size)));
+
+    // Swap-in dos page faults assíncronos roda na thread do IOManager
+    memManager.setAsyncPageFaults(config.main_memory.async_page_faults);
+    ioManager.setPageFaultHandler([this](PCB &process, uint32_t logicalAddress) {
+        memManager.servicePageFault(logicalAddress, process);
+    });
+    ioManager.setUnblockCallback([this](PCB *process) {
+        completionQueue.postUnblocked(process);
+    });
+
+    // Semente mestre: todos os geradores derivam dela. Na repetição vale a
+    // semente gravada no log. O lote de experimentos não grava nem repete.
+    ReplayMode replayMode = writeOutputs ? static_cast<ReplayMode>(config.simulation.replay_mode) : ReplayMode::OFF;
+    if (!replay.open(replayMode, config.simulation.replay_file, config.simulation.seed,
+                     config.scheduling.algorithm, std::max(1, config.cpu.cores))) {
+        return 1;
+    }
+    const uint64_t seed = replay.getSeed();
+    // Execução determinística: mesmas decisões e mesmos ciclos a cada execução
+    // com a mesma semente, à custa do paralelismo entre núcleos no hospedeiro
+    if (config.simulation.deterministic) {
+        config.cpu.pdes = true;
+    }
+    ioManager.setSeed(deriveSeed(seed, SeedStream::IO_DEVICES));
+    if (replay.getMode() == ReplayMode::REPLAY) {
+        ioManager.setCostOverride([this](const PCB &process, std::chrono::milliseconds &cost) {
+            uint64_t recorded = 0;
+            if (!replay.ioCost(process.pid, recorded)) {
+                return false;
+            }
+            cost = std::chrono::milliseconds(recorded);
+            return true;
+        });
+    }
+
+    scheduler = std::make_unique<ProcessScheduler>(config.scheduling.algorithm, readyQueue, seed);
+    scheduler->configureMlfq(config.scheduling.mlfq.levels,
+                             config.scheduling.mlfq.quanta,
+                             config.scheduling.mlfq.boost_interval);
+    scheduler->configureCfs(config.scheduling.cfs.target_latency,
+                            config.scheduling.cfs.min_granularity);
+    scheduler->configureRealtime(config.scheduling.realtime.quantum,
+                                 config.scheduling.realtime.jobs);
+    applyCachePartitioning(); // depois do escalonador, que pode sortear as prioridades
+
+    std::vector<std::string> templateNames;
+    for (const auto &[label, file] : templates) {
+        templateNames.push_back(label);
+    }
+    WorkloadConfig workloadConfig = config.workload;
+    if (workloadConfig.seed == 0) {
+        workloadConfig.seed = static_cast<unsigned>(deriveSeed(seed, SeedStream::WORKLOAD));
+    }
+    workload = std::make_unique<WorkloadGenerator>(workloadConfig, templateNames);
 
     std::cout << "\nIniciando escalonador " << schedulerName(config.scheduling.algorithm) << "...\n";
+    std::cout << "Semente mestre: " << seed << " | replay: " << replayModeName(replay.getMode()) << "\n";
 
     // Medir tempo de execução total
     auto startTime = std::chrono::high_resolution_clock::now();
@@ -45,6 +179,7 @@ int Simulator::run() {
     
     auto endTime = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsedSeconds = endTime - startTime;
+    summary.wallSeconds = elapsedSeconds.count();
     std::cout << "\nTempo total de execução do simulador: " << elapsedSeconds.count() << " segundos.\n";
 
     std::cout << "\nTodos os processos foram finalizados. Encerrando o simulador.\n";
@@ -62,29 +197,71 @@ bool Simulator::loadProcesses() {
     bool allLoaded = true;
     int processCount = 0;
     uint32_t nextBaseAddr = 0x00000000;
+    memManager.setDemandPaging(config.main_memory.demand_paging, config.main_memory.page_sharing);
 
     try {
+        std::vector<std::filesystem::path> taskPaths;
         for (const auto &entry : std::filesystem::directory_iterator(tasksDir)) {
-            if (entry.is_regular_file() && isJsonFile(entry.path())) {
-                std::string taskFile = entry.path().string();
-                std::string taskLabel = entry.path().filename().string();
-
-                std::cout << "Carregando task: " << taskLabel << "\n";
-                
-                allLoaded &= loadProcessDefinition(
-                    taskLabel,
-                    taskFile,
-                    nextBaseAddr,
-                    ++processCount
-                );
+            if (entry.is_regular_file() && isProgramSource(entry.path().string())) {
+                taskPaths.push_back(entry.path());
             }
         }
 
+        // Montagem em paralelo (cada arquivo com o próprio contexto, ou a imagem
+        // em cache); a instalação na memória continua serial e na ordem do diretório
+        if (!programs && !taskPaths.empty()) {
+            std::vector<std::string> files;
+            for (const auto &path : taskPaths) {
+                files.push_back(path.string());
+            }
+            auto start = std::chrono::steady_clock::now();
+            std::vector<ProgramImage> images = assembleProgramFiles(files, 0, config.simulation.image_cache);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+            auto cache = std::make_shared<ProgramCache>();
+            for (auto &image : images) {
+                std::string source = image.source;
+                (*cache)[source] = std::move(image);
+            }
+            programs = cache;
+            std::cout << "Montagem: " << files.size() << " programas em " << elapsed.count() << " ms\n";
+        }
+
+        for (const auto &path : taskPaths) {
+            std::string taskFile = path.string();
+            std::string taskLabel = path.filename().string();
+
+            // Carga aberta: as tasks são modelos instanciados a cada chegada
+            if (config.workload.mode != 0) {
+                templates.emplace_back(taskLabel, taskFile);
+                ++processCount;
+                continue;
+            }
+
+            std::cout << "Carregando task: " << taskLabel << "\n";
+            
+            allLoaded &= loadProcessDefinition(
+                taskLabel,
+                taskFile,
+                nextBaseAddr,
+                ++processCount
+            );
+        }
+
         if (processCount == 0) {
-            std::cerr << "Aviso: Nenhum arquivo .json encontrado em '" << tasksDir << "'.\n";
+            std::cerr << "Aviso: Nenhum programa (.json ou .s) encontrado em '" << tasksDir << "'.\n";
             return false;
         }
 
+        if (config.workload.mode != 0) {
+            std::sort(templates.begin(), templates.end());
+            std::cout << "Total de " << processCount << " modelos para a carga aberta.\n";
+            return true;
+        }
+
+        for (const auto &process : processList) {
+            readyQueue.push_back(process.get());
+        }
         std::cout << "Total de " << processCount << " tasks carregadas com sucesso.\n";
     } catch (const std::filesystem::filesystem_error &e) {
         std::cerr << "Erro ao acessar diretório '" << tasksDir << "': " << e.what() << "\n";
@@ -101,29 +278,56 @@ bool Simulator::loadProcessDefinition(
                                        int pid) {
     auto process = std::make_unique<PCB>();
     process->pid = pid;
-    PCB::registerProcess(process.get());
+    memManager.registerProcess(process.get());
     
     std::cout << "Carregando programa '" << taskLabel << "' para o processo " << process->pid << "...\n";
-    int startCodeAddr = loadJsonProgram(taskFile, memManager, *process, baseAddress);
+    // Imagem já montada; chegadas da carga aberta reaproveitam a mesma
+    const ProgramImage *image = nullptr;
+    if (programs) {
+        auto cached = programs->find(taskFile);
+        image = cached != programs->end() ? &cached->second : nullptr;
+    }
+    int startCodeAddr = image ? installProgram(*image, memManager, *process, static_cast<int>(baseAddress))
+                              : loadJsonProgram(taskFile, memManager, *process, static_cast<int>(baseAddress));
+    // Com paginação sob demanda o compartilhamento acontece no primeiro acesso
+    if (config.main_memory.page_sharing && !config.main_memory.demand_paging) {
+        memManager.mergeIdenticalPages(*process, static_cast<uint32_t>(startCodeAddr));
+    }
 
     process->regBank.pc.write(startCodeAddr);
+    process->entryPC = static_cast<uint32_t>(startCodeAddr);
     process->memWeights.cache = static_cast<uint64_t>(config.cache.weight);
     process->memWeights.primary = static_cast<uint64_t>(config.main_memory.weight);
     process->memWeights.secondary = static_cast<uint64_t>(config.secondary_memory.weight);
     
     process->arrivalTime.store(process->timeStamp);
 
-    readyQueue.push_back(process.get());
+    if (statsEnabled()) {
+        registerProcessStats(*process);
+    }
     processList.push_back(std::move(process));
     return true;
 }
 
+// O I/O termina na linha do tempo depois dos ciclos que o IOManager cobrou
+// do processo enquanto ele estava bloqueado (dispositivo ou swap-in)
 void Simulator::moveUnblockedProcesses() {
     for (auto it = blockedQueue.begin(); it != blockedQueue.end();) {
         if ((*it)->state.load() == State::Ready) {
             // std::cout << "[Scheduler] Processo " << (*it)->pid
             //           << " desbloqueado e movido para a fila de prontos.\n";
-            readyQueue.push_back(*it);
+            PCB &process = **it;
+            BlockRecord record = blockRecords[&process];
+            blockRecords.erase(&process);
+
+            uint64_t ioTime = (process.io_cycles.load() - record.ioCycles) +
+                              (process.memory_cycles.load() - record.memoryCycles);
+            process.blockedCycles.fetch_add(ioTime);
+            if (!record.pageFault) {
+                replay.ioComplete(record.since + ioTime, process.pid, process.io_cycles.load() - record.ioCycles);
+            }
+            scheduleReady(process, record.since + ioTime,
+                          record.pageFault ? SimEventType::PAGE_IN_COMPLETE : SimEventType::IO_COMPLETE);
             it = blockedQueue.erase(it);
         } else {
             ++it;
@@ -131,83 +335,297 @@ void Simulator::moveUnblockedProcesses() {
     }
 }
 
-void Simulator::executeProcesses() {
-    const int totalProcesses = static_cast<int>(processList.size());
-    int finishedProcesses = 0;
+// Instancia a próxima chegada da carga aberta. Só existe uma chegada futura
+// por vez na linha do tempo: a seguinte é gerada quando esta acontecer.
+void Simulator::admitNextArrival() {
+    Arrival arrival;
+    if (!workload || !workload->next(arrival)) {
+        return;
+    }
 
-    const int numCores = std::max(1, config.cpu.cores);
-    std::vector<std::unique_ptr<CPUCore>> cpuCores;
-    std::vector<PCB *> coreAssignments(numCores, nullptr);
-    std::queue<int> idleCoresIdx;
+    const auto &[label, file] = templates[arrival.templateIndex];
+    int pid = static_cast<int>(processList.size()) + 1;
+    if (!loadProcessDefinition(label, file, 0, pid)) {
+        return;
+    }
 
-    for (int i = 0; i < numCores; ++i) {
-        cpuCores.push_back(std::make_unique<CPUCore>(i, memManager, ioManager));
-        cpuCores.back()->start();
-        cpuCores.back()->setSchedulingAlgorithm(config.scheduling.algorithm);
-        idleCoresIdx.push(i);
+    PCB &process = *processList.back();
+    process.arrivalTime.store(arrival.time);
+    scheduler->admit(&process);
+    scheduleReady(process, arrival.time, SimEventType::ARRIVAL);
+}
+
+void Simulator::scheduleReady(PCB &process, uint64_t time, SimEventType type) {
+    process.readyAt = time;
+    timeline.schedule(time, type, &process);
+}
+
+// Nenhum processo em execução ou bloqueado volta a ficar pronto antes do
+// instante em que ficou pronto (ou bloqueou) pela última vez: eventos até esse
+// limite já podem ser entregues sem violar a ordem da linha do tempo
+uint64_t Simulator::safeHorizon(const std::unordered_map<PCB *, uint64_t> &inFlight) const {
+    uint64_t horizon = std::numeric_limits<uint64_t>::max();
+    for (const auto &[process, readyAt] : inFlight) {
+        horizon = std::min(horizon, readyAt);
+    }
+    for (const auto &[process, record] : blockRecords) {
+        horizon = std::min(horizon, record.since);
     }
+    return horizon;
+}
 
-    while (finishedProcesses < totalProcesses) {
+void Simulator::releaseDueEvents(uint64_t horizon) {
+    if (timeline.empty()) {
+        return;
+    }
+    // Nada em execução nem bloqueado: o relógio salta para o próximo evento
+    if (horizon == std::numeric_limits<uint64_t>::max()) {
+        horizon = timeline.nextTime();
+    }
+    while (!timeline.empty() && timeline.nextTime() <= horizon) {
+        SimEvent event = timeline.pop();
+        if (event.type == SimEventType::ARRIVAL) {
+            admitNextArrival();
+            // Sem limite, chegadas demais disputam os quadros e o sistema entra
+            // em thrashing: o excedente espera a saída de um processo
+            if (workload && workload->getMode() != ArrivalMode::STATIC && config.workload.max_active > 0 &&
+                activeProcesses >= config.workload.max_active) {
+                admissionQueue.push_back(event.process);
+                deferredAdmissions++;
+                continue;
+            }
+            activeProcesses++;
+        }
+        event.process->state.store(State::Ready);
+        readyQueue.push_back(event.process);
+    }
+}
+
+void Simulator::dispatchEvents(std::vector<std::unique_ptr<CPUCore>> &cpuCores, int &finishedProcesses) {
+    // Processos em filas locais ou executando (ainda sem evento de conclusão),
+    // com o instante em que ficaram prontos
+    std::unordered_map<PCB *, uint64_t> inFlight;
+    int nextCore = 0;
+
+    // Na carga aberta processList cresce: sempre há uma chegada futura já
+    // instanciada enquanto o gerador não atingir o horizonte
+    while (finishedProcesses < static_cast<int>(processList.size())) {
         collectMemoryMetrics(); // Coleta métricas a cada iteração do loop principal
-        moveUnblockedProcesses();
-        reclaimFinishedCores(cpuCores, coreAssignments, idleCoresIdx, finishedProcesses);
+        updateStats();
+
+        releaseDueEvents(safeHorizon(inFlight));
+        for (PCB *process : readyQueue) {
+            int core = selectCore(*process, cpuCores, nextCore);
+            replay.dispatch(process->readyAt, process->pid, core);
+            cpuCores[core]->enqueue(process);
+            inFlight.emplace(process, process->readyAt);
+        }
+        readyQueue.clear();
 
-        if (readyQueue.empty()) {
-            reclaimFinishedCores(cpuCores, coreAssignments, idleCoresIdx, finishedProcesses);
+        if (blockedQueue.empty() && inFlight.empty() && timeline.empty()) {
+            break;
+        }
+        // Só saíram chegadas para a fila de admissão: nada vai acordar o
+        // despachante, então o relógio segue para o próximo evento
+        if (blockedQueue.empty() && inFlight.empty()) {
+            continue;
+        }
 
-            if (blockedQueue.empty() && readyQueue.empty() && allCoresIdle(coreAssignments)) {
-                break;
+        // Dorme até um núcleo terminar ou um processo ser desbloqueado
+        for (const CompletionEvent &event : completionQueue.waitAll()) {
+            if (event.type == CompletionEventType::CORE_IDLE && event.process) {
+                inFlight.erase(event.process);
+                recordSliceEnd(*event.process, event.coreId);
+                scheduler->onSliceEnd(*event.process);
+                handleCompletion(*event.process, finishedProcesses);
             }
+        }
+        moveUnblockedProcesses();
+    }
+}
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(20));
-            continue;
+// Largura da janela conservadora: nenhum núcleo enxerga o efeito de outro na
+// memória compartilhada antes da latência de um acesso à RAM
+uint64_t Simulator::pdesLookahead() const {
+    if (config.cpu.pdes_lookahead > 0) {
+        return static_cast<uint64_t>(config.cpu.pdes_lookahead);
+    }
+    return static_cast<uint64_t>(std::max(1, config.main_memory.weight));
+}
+
+// Simulação paralela conservadora: cada núcleo é um processo lógico na própria
+// thread e só sincroniza com os demais nas fronteiras das janelas. A janela
+// começa no próximo evento da linha do tempo e dura 'lookahead' ciclos; os
+// eventos dentro dela saem juntos, os núcleos executam as próprias filas em
+// paralelo e, na barreira, as conclusões são aplicadas em ordem de (término,
+// núcleo), e não na ordem em que as threads do hospedeiro terminaram.
+void Simulator::dispatchWindows(std::vector<std::unique_ptr<CPUCore>> &cpuCores, int &finishedProcesses) {
+    const uint64_t lookahead = pdesLookahead();
+    const std::unordered_map<PCB *, uint64_t> noneInFlight;
+    int nextCore = 0;
+
+    while (finishedProcesses < static_cast<int>(processList.size())) {
+        collectMemoryMetrics();
+        updateStats();
+
+        if (blockedQueue.empty() && timeline.empty()) {
+            break;
         }
 
-        PCB *currentProcess = scheduler->scheduler(readyQueue);
-        readyQueue.erase(std::remove(readyQueue.begin(), readyQueue.end(), currentProcess), readyQueue.end());
+        // Um I/O de dispositivo em andamento ainda pode gerar um evento anterior
+        // ao próximo da linha do tempo: espera o IOManager devolver o processo
+        uint64_t horizon = safeHorizon(noneInFlight);
+        if (timeline.empty() || timeline.nextTime() > horizon) {
+            completionQueue.waitAll();
+            moveUnblockedProcesses();
+            continue;
+        }
 
-        currentProcess->state.store(State::Running);
+        releaseDueEvents(std::min(horizon, timeline.nextTime() + lookahead - 1));
+        if (readyQueue.empty()) {
+            continue;  // Só saíram chegadas para a fila de admissão
+        }
 
-        while (idleCoresIdx.empty()) {
-            reclaimFinishedCores(cpuCores, coreAssignments, idleCoresIdx, finishedProcesses);
-            if (idleCoresIdx.empty()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        // Distribui a janela inteira antes de qualquer núcleo começar
+        for (auto &core : cpuCores) {
+            core->hold();
+        }
+        std::vector<std::size_t> coreSlices(cpuCores.size(), 0);
+        const std::size_t dispatched = readyQueue.size();
+        for (PCB *process : readyQueue) {
+            int core = selectCore(*process, cpuCores, nextCore);
+            replay.dispatch(process->readyAt, process->pid, core);
+            cpuCores[core]->enqueue(process);
+            coreSlices[core]++;
+        }
+        readyQueue.clear();
+
+        std::vector<std::pair<std::size_t, PCB *>> finished;
+        auto collect = [&](std::size_t target) {
+            while (finished.size() < target) {
+                for (const CompletionEvent &event : completionQueue.waitAll()) {
+                    if (event.type == CompletionEventType::CORE_IDLE && event.process) {
+                        finished.emplace_back(event.coreId, event.process);
+                    }
+                }
+            }
+        };
+        if (config.simulation.deterministic) {
+            // Um núcleo por vez, em ordem: a cache e a RAM compartilhadas veem
+            // os acessos sempre na mesma sequência
+            std::size_t target = 0;
+            for (std::size_t core = 0; core < cpuCores.size(); ++core) {
+                cpuCores[core]->release();
+                target += coreSlices[core];
+                collect(target);
+            }
+        } else {
+            for (auto &core : cpuCores) {
+                core->release();
             }
+            // Barreira: todas as fatias da janela terminaram
+            collect(dispatched);
         }
+        std::sort(finished.begin(), finished.end(), [](const auto &a, const auto &b) {
+            if (a.second->lastRunEnd != b.second->lastRunEnd) {
+                return a.second->lastRunEnd < b.second->lastRunEnd;
+            }
+            return a.first < b.first;
+        });
+        for (const auto &[coreId, process] : finished) {
+            recordSliceEnd(*process, coreId);
+            scheduler->onSliceEnd(*process);
+            handleCompletion(*process, finishedProcesses);
+        }
+        moveUnblockedProcesses();
 
-        int coreIdx = idleCoresIdx.front();
-        idleCoresIdx.pop();
-        coreAssignments[coreIdx] = currentProcess;
-        cpuCores[coreIdx]->submitProcess(currentProcess, false);
-        currentProcess->coresAssigned.push_back(coreIdx);
-        // {
-        //     std::lock_guard<std::mutex> lock(printMutex);
-        //     // std::cout << "\n[Scheduler] Executando processo " << currentProcess->pid
-        //     //         << " (Quantum: " << currentProcess->quantum
-        //     //         << ") (Prioridade: " << currentProcess->priority << ")"
-        //     //         << ") (Intruções: " << currentProcess->instructions << ").\n";
-        // }
+        std::size_t activeCores = cpuCores.size() - std::count(coreSlices.begin(), coreSlices.end(), std::size_t{0});
+        pdesStats.windows++;
+        pdesStats.slices += dispatched;
+        pdesStats.activeCores += activeCores;
+        pdesStats.maxActiveCores = std::max(pdesStats.maxActiveCores, activeCores);
     }
+}
 
-    reclaimFinishedCores(cpuCores, coreAssignments, idleCoresIdx, finishedProcesses);
+void Simulator::executeProcesses() {
+    int finishedProcesses = 0;
+
+    const int numCores = std::max(1, config.cpu.cores);
+    std::vector<std::unique_ptr<CPUCore>> cpuCores;
+
+    for (int i = 0; i < numCores; ++i) {
+        cpuCores.push_back(std::make_unique<CPUCore>(i, memManager, ioManager));
+        cpuCores.back()->setSchedulingAlgorithm(config.scheduling.algorithm);
+        // Cada núcleo escalona a própria fila com a estrutura da política configurada
+        cpuCores.back()->setReadyQueue(scheduler->makeReadyQueue(i));
+        cpuCores.back()->setMigrationPenalty(static_cast<uint64_t>(std::max(0, config.cpu.migration_penalty)));
+        cpuCores.back()->setSerialPipeline(config.simulation.deterministic);
+        cpuCores.back()->setCompletionCallback([this](std::size_t coreId, PCB *process) {
+            completionQueue.postCoreIdle(coreId, process);
+        });
+    }
+
+    // Vizinhos em ordem circular a partir do próximo núcleo, para espalhar os roubos.
+    // Nas janelas conservadoras não há roubo: quem executa o quê depende só do despachante.
+    for (int i = 0; i < numCores && !config.cpu.pdes; ++i) {
+        std::vector<CPUCore *> peers;
+        for (int k = 1; k < numCores; ++k) {
+            peers.push_back(cpuCores[(i + k) % numCores].get());
+        }
+        cpuCores[i]->setPeers(peers);
+    }
+
+    if (statsEnabled()) {
+        registerSystemStats(cpuCores);
+        nextStatsDump = config.simulation.stats_dump_interval;
+    }
+
+    for (auto &core : cpuCores) {
+        core->start();
+    }
+
+    // Todos os processos carregados chegam na linha do tempo
+    for (PCB *process : readyQueue) {
+        scheduleReady(*process, process->arrivalTime.load(), SimEventType::ARRIVAL);
+    }
+    readyQueue.clear();
+    admitNextArrival();
+
+    if (config.cpu.pdes) {
+        dispatchWindows(cpuCores, finishedProcesses);
+    } else {
+        dispatchEvents(cpuCores, finishedProcesses);
+    }
     
-    saveMemoryMetrics();
+    if (writeOutputs) {
+        saveMemoryMetrics();
+        saveCacheSetMetrics();
+        saveCacheOccupancyMetrics();
+        saveMigrationMetrics();
+        saveArrivalMetrics();
+        replay.save();
+        if (statsEnabled()) {
+            saveStats();
+        }
+    }
 
     for (auto &core : cpuCores) {
         core->stop();
     }
 
     for(auto process : finishedQueue) {
-        print_metrics(*process);
+        if (writeOutputs) {
+            print_metrics(*process);
+        }
         memManager.freeProcessPages(*process);
     }
 
-    uint64_t totalBurstTime = 0;     // soma do tempo de CPU consumido
+    uint64_t totalBurstTime = 0;     // soma do tempo de CPU consumido (fatias na linha do tempo)
     uint64_t totalTurnaround = 0;    // soma do turnaround
     uint64_t totalWaiting = 0;       // soma do waiting time
 
     for (auto process : finishedQueue) {
-        totalBurstTime += process->burstTime.load();
+        totalBurstTime += process->serviceCycles.load();
         totalTurnaround += process->turnaroundTime.load();
         totalWaiting += process->waitingTime.load();
     }
@@ -239,12 +657,499 @@ void Simulator::executeProcesses() {
     // Throughput global (processos concluídos / tempo total)
     double throughput = static_cast<double>(n) / totalSimTime;
 
+    uint64_t totalResponse = 0;
+    uint64_t cacheAccesses = 0;
+    uint64_t cacheHits = 0;
+    for (auto process : finishedQueue) {
+        totalResponse += process->responseTime.load();
+        cacheAccesses += process->cache_mem_accesses.load();
+        cacheHits += process->cache_read_hits.load() + process->cache_write_hits.load();
+        summary.migrations += process->migrations.load();
+        summary.deadlineMisses += process->rt ? process->rt->deadlineMisses : 0;
+    }
+    summary.processes = n;
+    summary.simulatedCycles = totalSimTime;
+    summary.avgWaiting = avgWaitingTime;
+    summary.avgTurnaround = avgTurnaroundTime;
+    summary.avgResponse = n > 0 ? static_cast<double>(totalResponse) / n : 0.0;
+    summary.cpuUtilization = cpuUtilization;
+    summary.throughput = totalSimTime > 0 ? 1000.0 * n / totalSimTime : 0.0;
+    summary.cacheHitRate = cacheAccesses > 0 ? static_cast<double>(cacheHits) / cacheAccesses : 0.0;
+    summary.jainIndex = jainIndex(contentionShares);
+
     std::cout << "\n=== MÉTRICAS GLOBAIS DO SIMULADOR ===\n";
     std::cout << "Tempo médio de espera: " << avgWaitingTime << " ciclos\n";
     std::cout << "Tempo médio de execução: " << avgTurnaroundTime << " ciclos\n";
     std::cout << "Utilização média da CPU: " << cpuUtilization * 100 << " %\n";
     std::cout << "Eficiência: " << efficiency * 100 << " %\n";
     std::cout << "Throughput global: " << throughput << " processos/ciclo\n";
+    std::cout << "Relógio global: " << totalSimTime << " ciclos simulados | "
+              << timeline.getProcessed() << " eventos (chegadas "
+              << timeline.getProcessed(SimEventType::ARRIVAL) << ", fim de fatia "
+              << timeline.getProcessed(SimEventType::SLICE_END) << ", I/O "
+              << timeline.getProcessed(SimEventType::IO_COMPLETE) << ", swap-in "
+              << timeline.getProcessed(SimEventType::PAGE_IN_COMPLETE) << ", jobs "
+              << timeline.getProcessed(SimEventType::JOB_RELEASE) << ", admissões "
+              << timeline.getProcessed(SimEventType::ADMISSION) << ")\n";
+    if (config.cpu.pdes && pdesStats.windows > 0) {
+        std::cout << "Janelas conservadoras: " << pdesStats.windows << " de " << pdesLookahead()
+                  << " ciclos | fatias por janela "
+                  << static_cast<double>(pdesStats.slices) / pdesStats.windows
+                  << " | núcleos ativos por janela "
+                  << static_cast<double>(pdesStats.activeCores) / pdesStats.windows
+                  << " (máx " << pdesStats.maxActiveCores << ")\n";
+    }
+    std::cout << "Despachante: " << completionQueue.getDelivered() << " eventos em "
+              << completionQueue.getWakeups() << " despertares | latência média "
+              << completionQueue.getAverageLatencyUs() << " us (máx "
+              << completionQueue.getMaxLatencyUs() << " us)\n";
+    printLatencySummary(cpuCores);
+
+    std::cout << "\n=== FILAS POR NÚCLEO (WORK STEALING) ===\n";
+    uint64_t totalSteals = 0;
+    uint64_t totalMigrations = 0;
+    for (const auto &core : cpuCores) {
+        CoreQueueStats qs = core->getQueueStats();
+        totalSteals += qs.steals;
+        totalMigrations += qs.migrations;
+        std::cout << "Núcleo " << core->id() << ": " << qs.slices << " fatias | "
+                  << qs.steals << " roubos em " << qs.stealAttempts << " tentativas | "
+                  << qs.migrations << " migrações\n";
+    }
+    std::cout << "Total: " << totalSteals << " roubos | " << totalMigrations << " migrações\n";
+    uint64_t totalMigrationCycles = 0;
+    for (const auto &core : cpuCores) {
+        totalMigrationCycles += core->getQueueStats().migrationCycles;
+    }
+    std::cout << "Afinidade: " << (config.cpu.affinity == 1 ? "suave" : "desligada")
+              << " | penalidade por migração " << config.cpu.migration_penalty << " ciclos | "
+              << totalMigrationCycles << " ciclos cobrados\n";
+
+    // Justiça: índice de Jain sobre a CPU recebida (dividida pelo peso) por
+    // cada processo enquanto todos disputavam a CPU
+    std::cout << "Índice de Jain (CPU por processo até o 1º término): "
+              << jainIndex(contentionShares) << " (" << contentionShares.size() << " processos)\n";
+
+    if (config.scheduling.algorithm == 5) {
+        printMlfqSummary();
+    }
+    printRealtimeSummary(cpuCores);
+    printOpenWorkloadSummary(numCores);
+    replay.printSummary();
+
+    PageSharingStats sharing = memManager.getPageSharingStats();
+    std::cout << "\n=== COMPARTILHAMENTO DE PÁGINAS (COW) ===\n";
+    std::cout << "Páginas compartilhadas " << (config.main_memory.demand_paging ? "no primeiro acesso" : "na carga")
+              << ": " << sharing.mergedPages << " (" << sharing.mergedCodePages << " de código)\n";
+    std::cout << "COW faults (cópias por escrita): " << sharing.cowFaults << "\n";
+
+    uint64_t asyncFaults = 0;
+    for (auto process : finishedQueue) {
+        asyncFaults += process->async_page_faults.load();
+    }
+    std::cout << "Page faults assíncronos (processo bloqueado): " << asyncFaults
+              << (config.main_memory.async_page_faults ? "" : " (desabilitado)") << "\n";
+    if (config.main_memory.demand_paging) {
+        DemandPagingStats demand = memManager.getDemandPagingStats();
+        std::cout << "Paginação sob demanda: " << demand.loadedPages << " páginas preenchidas no primeiro acesso"
+                  << " de " << demand.mappedPages << " cobertas pelas imagens dos programas\n";
+    }
+
+    CacheWriteStats writeStats = memManager.getCacheWriteStats();
+    std::cout << "\n=== TRÁFEGO DE ESCRITA DA CACHE ===\n";
+    std::cout << "Política de escrita: "
+              << (config.cache.write_policy == 1 ? "Write-Through" : "Write-Back")
+              << (config.cache.write_allocate ? " / Write-Allocate" : " / No-Write-Allocate") << "\n";
+    std::cout << "Write-backs de linhas sujas: " << writeStats.writebackBlocks << "\n";
+    std::cout << "Palavras propagadas (write-through/no-allocate): " << writeStats.writeThroughWords << "\n";
+    std::cout << "Write buffer: " << config.cache.write_buffer_size << " entradas | "
+              << writeStats.bufferedWrites << " enfileiradas | "
+              << writeStats.coalescedWrites << " coalescidas | "
+              << writeStats.drainedEntries << " drenadas em segundo plano\n";
+    std::cout << "Stalls por buffer cheio: " << writeStats.stallDrains
+              << " (" << writeStats.stallCycles << " ciclos)\n";
+
+    CacheMissBreakdown misses = memManager.getCacheMissBreakdown();
+    std::cout << "\n=== CLASSIFICAÇÃO DOS MISSES DA CACHE ===\n";
+    std::cout << "Associatividade: " << memManager.getCacheAssociativity() << " vias | Victim cache: "
+              << config.cache.victim_cache_size << " entradas\n";
+    std::cout << "Compulsórios: " << misses.compulsory
+              << " | Capacidade: " << misses.capacity
+              << " | Conflito: " << misses.conflict
+              << " | Invalidação (swap): " << misses.invalidation << "\n";
+    std::cout << "Hits na victim cache: " << memManager.getCacheVictimHits() << "\n";
+
+    std::map<int, CacheOccupancy> occupancy = memManager.getCacheOccupancy();
+    std::cout << "\n=== PARTICIONAMENTO DA CACHE ===\n";
+    std::cout << "Modo: " << partitionModeName(memManager.getCachePartitionMode())
+              << " | Reparticionamentos: " << memManager.getCacheRepartitions() << "\n";
+    for (const auto &[pid, occ] : occupancy) {
+        double avgLines = (occ.accesses > 0) ? static_cast<double>(occ.lineSamples) / occ.accesses : 0.0;
+        std::cout << "PID " << pid << ": máscara " << hexMask(occ.wayMask)
+                  << " | linhas " << occ.lines << " (pico " << occ.peakLines
+                  << ", média " << avgLines << ") | misses " << occ.misses
+                  << "/" << occ.accesses << "\n";
+    }
+}
+
+// Afinidade suave: o processo volta ao último núcleo, onde a cache está
+// quente, a menos que ele esteja mais carregado que o menos ocupado além da
+// tolerância. Sem afinidade, todo despacho segue o rodízio.
+int Simulator::selectCore(const PCB &process,
+                          const std::vector<std::unique_ptr<CPUCore>> &cpuCores,
+                          int &nextCore) const {
+    const int numCores = static_cast<int>(cpuCores.size());
+    if (config.cpu.affinity != 1) {
+        return nextCore++ % numCores;
+    }
+
+    // Menos carregado, começando do rodízio para espalhar os empates
+    int leastLoaded = nextCore % numCores;
+    for (int k = 1; k < numCores; ++k) {
+        int candidate = (nextCore + k) % numCores;
+        if (cpuCores[candidate]->load() < cpuCores[leastLoaded]->load()) {
+            leastLoaded = candidate;
+        }
+    }
+
+    if (process.coresAssigned.empty()) {
+        nextCore++;
+        return leastLoaded;
+    }
+
+    int last = process.coresAssigned.back();
+    std::size_t tolerance = static_cast<std::size_t>(std::max(0, config.cpu.affinity_imbalance));
+    if (cpuCores[last]->load() <= cpuCores[leastLoaded]->load() + tolerance) {
+        return last;
+    }
+    return leastLoaded;
+}
+
+// CPU recebida por processo (normalizada pelo peso) no momento do primeiro
+// término, quando todos ainda competiam pela CPU
+void Simulator::captureContentionShares() {
+    contentionShares.clear();
+    for (const auto &process : processList) {
+        contentionShares.push_back(process->burstTime.load() / scheduler->shareWeight(*process));
+    }
+}
+
+// Índice de Jain: (soma x)^2 / (n * soma x^2); 1 = divisão perfeitamente justa
+double Simulator::jainIndex(const std::vector<double> &shares) {
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    for (double x : shares) {
+        sum += x;
+        sumSquares += x * x;
+    }
+    if (shares.empty() || sumSquares == 0.0) {
+        return 0.0;
+    }
+    return (sum * sum) / (shares.size() * sumSquares);
+}
+
+bool Simulator::statsEnabled() const {
+    return writeOutputs && !config.simulation.stats_file.empty();
+}
+
+// process.<pid>.*: lê os contadores do PCB na hora do retrato
+void Simulator::registerProcessStats(PCB &process) {
+    static const std::vector<std::pair<const char *, std::atomic<uint64_t> PCB::*>> COUNTERS = {
+        {"pipeline_cycles", &PCB::pipeline_cycles},
+        {"instructions", &PCB::instructions_retired},
+        {"service_cycles", &PCB::serviceCycles},
+        {"blocked_cycles", &PCB::blockedCycles},
+        {"memory_cycles", &PCB::memory_cycles},
+        {"io_cycles", &PCB::io_cycles},
+        {"mem.reads", &PCB::mem_reads},
+        {"mem.writes", &PCB::mem_writes},
+        {"mem.primary_accesses", &PCB::primary_mem_accesses},
+        {"mem.secondary_accesses", &PCB::secondary_mem_accesses},
+        {"mem.cow_faults", &PCB::cow_faults},
+        {"mem.async_page_faults", &PCB::async_page_faults},
+        {"cache.accesses", &PCB::cache_mem_accesses},
+        {"cache.hits", &PCB::cache_hits},
+        {"cache.misses", &PCB::cache_misses},
+        {"cache.read_misses", &PCB::cache_read_misses},
+        {"cache.write_misses", &PCB::cache_write_misses},
+        {"cache.victim_hits", &PCB::victim_cache_hits},
+        {"cache.write_buffer_stall_cycles", &PCB::write_buffer_stall_cycles},
+        {"migrations", &PCB::migrations},
+        {"migration_cycles", &PCB::migration_cycles},
+    };
+    static const std::vector<std::pair<const char *, std::atomic<uint64_t> PCB::*>> TIMES = {
+        {"arrival", &PCB::arrivalTime},
+        {"start", &PCB::startTime},
+        {"finish", &PCB::finishTime},
+        {"turnaround", &PCB::turnaroundTime},
+        {"waiting", &PCB::waitingTime},
+        {"response", &PCB::responseTime},
+    };
+
+    const std::string prefix = "process." + std::to_string(process.pid) + ".";
+    PCB *pcb = &process;
+    for (const auto &[name, field] : COUNTERS) {
+        stats.addScalar(prefix + name, [pcb, field = field] { return static_cast<double>((pcb->*field).load()); });
+    }
+    for (const auto &[name, field] : TIMES) {
+        stats.addGauge(prefix + "time." + name, [pcb, field = field] { return static_cast<double>((pcb->*field).load()); });
+    }
+    stats.addGauge(prefix + "time.execution", [pcb] { return static_cast<double>(pcb->totalTimeExecution()); },
+                   "Tempo total de execução (pipeline + memória + I/O + migração)");
+    stats.addFormula(prefix + "ipc", [prefix](const StatsRegistry &s) {
+        return s.ratio(prefix + "instructions", prefix + "service_cycles");
+    }, "Instruções por ciclo de serviço");
+    stats.addFormula(prefix + "cache.hit_rate", [prefix](const StatsRegistry &s) {
+        return s.ratio(prefix + "cache.hits", prefix + "cache.accesses");
+    });
+}
+
+// system.*: núcleos, cache L1, memória, linha do tempo e despachante
+void Simulator::registerSystemStats(const std::vector<std::unique_ptr<CPUCore>> &cpuCores) {
+    stats.addGauge("system.cycles", [this] { return static_cast<double>(statsClock()); },
+                   "Relógio simulado no retrato");
+    stats.addScalar("system.events", [this] { return static_cast<double>(timeline.getProcessed()); });
+    stats.addScalar("system.dispatcher.events", [this] { return static_cast<double>(completionQueue.getDelivered()); });
+    stats.addScalar("system.dispatcher.wakeups", [this] { return static_cast<double>(completionQueue.getWakeups()); });
+    if (config.cpu.pdes) {
+        stats.addScalar("system.pdes.windows", [this] { return static_cast<double>(pdesStats.windows); });
+        stats.addScalar("system.pdes.slices", [this] { return static_cast<double>(pdesStats.slices); });
+    }
+
+    for (const auto &core : cpuCores) {
+        const std::string prefix = "system.core" + std::to_string(core->id()) + ".";
+        const CPUCore *c = core.get();
+        stats.addScalar(prefix + "slices", [c] { return static_cast<double>(c->getQueueStats().slices); });
+        stats.addScalar(prefix + "steals", [c] { return static_cast<double>(c->getQueueStats().steals); });
+        stats.addScalar(prefix + "steal_attempts", [c] { return static_cast<double>(c->getQueueStats().stealAttempts); });
+        stats.addScalar(prefix + "migrations", [c] { return static_cast<double>(c->getQueueStats().migrations); });
+        stats.addScalar(prefix + "migration_cycles", [c] { return static_cast<double>(c->getQueueStats().migrationCycles); });
+    }
+
+    auto setTotal = [this](uint64_t CacheSetStats::*field) {
+        return [this, field] {
+            uint64_t total = 0;
+            for (const CacheSetStats &set : memManager.getCacheSetStats()) {
+                total += set.*field;
+            }
+            return static_cast<double>(total);
+        };
+    };
+    stats.addScalar("system.l1d.accesses", setTotal(&CacheSetStats::accesses));
+    stats.addScalar("system.l1d.misses", setTotal(&CacheSetStats::misses));
+    stats.addScalar("system.l1d.evictions", setTotal(&CacheSetStats::evictions));
+    stats.addFormula("system.l1d.hit_rate", [](const StatsRegistry &s) {
+        double accesses = s.value("system.l1d.accesses");
+        return accesses > 0 ? 1.0 - s.value("system.l1d.misses") / accesses : 0.0;
+    });
+    std::vector<std::string> setNames;
+    for (std::size_t i = 0; i < memManager.getCacheSetStats().size(); ++i) {
+        setNames.push_back("set" + std::to_string(i));
+    }
+    stats.addVector("system.l1d.set_misses", setNames, [this] {
+        std::vector<double> misses;
+        for (const CacheSetStats &set : memManager.getCacheSetStats()) {
+            misses.push_back(static_cast<double>(set.misses));
+        }
+        return misses;
+    }, "Misses por conjunto da cache");
+    stats.addScalar("system.l1d.miss.compulsory", [this] { return static_cast<double>(memManager.getCacheMissBreakdown().compulsory); });
+    stats.addScalar("system.l1d.miss.capacity", [this] { return static_cast<double>(memManager.getCacheMissBreakdown().capacity); });
+    stats.addScalar("system.l1d.miss.conflict", [this] { return static_cast<double>(memManager.getCacheMissBreakdown().conflict); });
+    stats.addScalar("system.l1d.miss.invalidation", [this] { return static_cast<double>(memManager.getCacheMissBreakdown().invalidation); });
+    stats.addScalar("system.l1d.victim_hits", [this] { return static_cast<double>(memManager.getCacheVictimHits()); });
+    stats.addScalar("system.l1d.writebacks", [this] { return static_cast<double>(memManager.getCacheWriteStats().writebackBlocks); });
+    stats.addScalar("system.l1d.write_buffer.buffered", [this] { return static_cast<double>(memManager.getCacheWriteStats().bufferedWrites); });
+    stats.addScalar("system.l1d.write_buffer.coalesced", [this] { return static_cast<double>(memManager.getCacheWriteStats().coalescedWrites); });
+    stats.addScalar("system.l1d.write_buffer.stall_cycles", [this] { return static_cast<double>(memManager.getCacheWriteStats().stallCycles); });
+
+    stats.addScalar("system.memory.cow_faults", [this] { return static_cast<double>(memManager.getPageSharingStats().cowFaults); });
+    stats.addGauge("system.memory.merged_pages", [this] { return static_cast<double>(memManager.getPageSharingStats().mergedPages); });
+    stats.addScalar("system.memory.demand_loaded_pages", [this] { return static_cast<double>(memManager.getDemandPagingStats().loadedPages); });
+    stats.addGauge("system.memory.usage.cache", [this] { return static_cast<double>(memManager.getCacheUsage()); },
+                   "Linhas válidas na cache");
+    stats.addGauge("system.memory.usage.ram", [this] { return static_cast<double>(memManager.getMainMemoryUsage()); },
+                   "Quadros ocupados na RAM");
+    stats.addGauge("system.memory.usage.disk", [this] { return static_cast<double>(memManager.getSecondaryMemoryUsage()); });
+
+    for (const auto &core : cpuCores) {
+        const std::string prefix = "system.core" + std::to_string(core->id()) + ".";
+        const CPUCore *c = core.get();
+        const std::size_t id = core->id();
+        stats.addHistogram(prefix + "dispatch_wait", [c] { return c->getDispatchWait(); });
+        for (std::size_t level = 0; level < static_cast<std::size_t>(MemoryLevel::COUNT); ++level) {
+            stats.addHistogram(prefix + "mem_latency." + MEMORY_LEVEL_NAMES[level],
+                               [this, id, level] { return memManager.getMemoryLatency(id)[level]; });
+        }
+    }
+    stats.addHistogram("system.dispatch_wait", [&cpuCores] { return mergedDispatchWait(cpuCores); },
+                       "Espera na fila de prontos até o início de cada fatia (ciclos)");
+    for (std::size_t level = 0; level < static_cast<std::size_t>(MemoryLevel::COUNT); ++level) {
+        stats.addHistogram(std::string("system.mem_latency.") + MEMORY_LEVEL_NAMES[level],
+                           [this, level, n = cpuCores.size()] { return mergedMemoryLatency(memManager, n)[level]; },
+                           "Ciclos por acesso que chegou até este nível");
+    }
+    stats.addHistogram("system.io.service", [this] { return ioManager.getServiceLatency(); },
+                       "Custo de cada operação de dispositivo (ciclos)");
+    stats.addHistogram("system.memory.page_in", [this] { return memManager.getPageInLatency(); },
+                       "Ciclos de cada swap-in assíncrono");
+
+    turnaroundHistogram = &stats.addHistogram("system.process.turnaround", "Turnaround dos processos finalizados (ciclos)");
+    responseHistogram = &stats.addHistogram("system.process.response", "Tempo de resposta dos processos finalizados (ciclos)");
+}
+
+// Relógio dos retratos: o último evento da linha do tempo ou o último término, o que vier depois
+uint64_t Simulator::statsClock() const {
+    uint64_t now = timeline.now();
+    for (const PCB *process : finishedQueue) {
+        now = std::max(now, process->finishTime.load());
+    }
+    return now;
+}
+
+// Chamado pelo despachante a cada passo: fim do aquecimento e retratos
+// periódicos seguem o relógio simulado, e não o tempo do hospedeiro
+void Simulator::updateStats() {
+    if (!statsEnabled()) {
+        return;
+    }
+    const uint64_t now = statsClock();
+    if (!statsWarmedUp && config.simulation.stats_warmup_cycles > 0) {
+        if (now < config.simulation.stats_warmup_cycles) {
+            return;  // Sem retratos durante o aquecimento
+        }
+        stats.reset(now);
+        statsWarmedUp = true;
+        nextStatsDump = now + config.simulation.stats_dump_interval;
+    }
+    if (config.simulation.stats_dump_interval > 0 && now >= nextStatsDump) {
+        stats.dump(now);
+        nextStatsDump = now + config.simulation.stats_dump_interval;
+    }
+}
+
+void Simulator::saveStats() {
+    stats.dump(statsClock());
+    if (stats.write(config.simulation.stats_file)) {
+        std::cout << "Estatísticas (" << stats.dumpCount() << " retratos) salvas em: "
+                  << config.simulation.stats_file << "\n";
+    }
+}
+
+// Residência e espera por nível da MLFQ
+void Simulator::printMlfqSummary() const {
+    const int levels = scheduler->getMlfqLevels();
+
+    std::cout << "\n=== MLFQ ===\n";
+    std::cout << "Níveis: " << levels << " | Boosts: " << scheduler->getMlfqBoosts() << "\n";
+
+    uint64_t allCycles = 0;
+    for (auto process : finishedQueue) {
+        for (int level = 0; process->mlfq && level < levels; ++level) {
+            allCycles += process->mlfq->cycles[level].load();
+        }
+    }
+
+    for (int level = 0; level < levels; ++level) {
+        uint64_t slices = 0;
+        uint64_t cycles = 0;
+        uint64_t waitNs = 0;
+        for (auto process : finishedQueue) {
+            if (process->mlfq) {
+                slices += process->mlfq->slices[level].load();
+                cycles += process->mlfq->cycles[level].load();
+                waitNs += process->mlfq->waitNs[level].load();
+            }
+        }
+        double share = allCycles ? 100.0 * cycles / allCycles : 0.0;
+        double avgWaitUs = slices ? waitNs / 1000.0 / slices : 0.0;
+        std::cout << "Nível " << level << " (quantum " << scheduler->getMlfqQuantum(level) << "): "
+                  << slices << " fatias | " << cycles << " ciclos (" << share << " %) | "
+                  << "espera média até o despacho " << avgWaitUs << " us\n";
+    }
+
+    for (auto process : finishedQueue) {
+        std::cout << "PID " << process->pid << " ciclos por nível:";
+        for (int level = 0; level < levels; ++level) {
+            std::cout << " " << (process->mlfq ? process->mlfq->cycles[level].load() : 0);
+        }
+        std::cout << "\n";
+    }
+}
+
+// Jobs, deadlines perdidos e folga de cada tarefa periódica, mais o teste de
+// utilização: U <= n(2^(1/n) - 1) garante o RM e U <= 1 o EDF (por núcleo)
+// Caudas das latências: as médias acima escondem os acessos e as esperas lentas
+void Simulator::printLatencySummary(const std::vector<std::unique_ptr<CPUCore>> &cpuCores) const {
+    std::cout << "\n=== LATÊNCIAS (ciclos) ===\n";
+    MemoryLatency memory = mergedMemoryLatency(memManager, cpuCores.size());
+    printLatency("Acesso à memória - cache", memory[static_cast<std::size_t>(MemoryLevel::CACHE)], "acessos");
+    printLatency("Acesso à memória - RAM  ", memory[static_cast<std::size_t>(MemoryLevel::RAM)], "acessos");
+    printLatency("Acesso à memória - swap ", memory[static_cast<std::size_t>(MemoryLevel::SWAP)], "acessos");
+    printLatency("Swap-in assíncrono      ", memManager.getPageInLatency(), "page faults");
+    printLatency("Espera por despacho     ", mergedDispatchWait(cpuCores), "fatias");
+    printLatency("Serviço de I/O          ", ioManager.getServiceLatency(), "operações");
+
+    StatHistogram turnaround;
+    StatHistogram response;
+    for (const PCB *process : finishedQueue) {
+        turnaround.sample(process->turnaroundTime.load());
+        response.sample(process->responseTime.load());
+    }
+    printLatency("Turnaround              ", turnaround, "processos");
+    printLatency("Resposta                ", response, "processos");
+}
+
+void Simulator::printRealtimeSummary(const std::vector<std::unique_ptr<CPUCore>> &cpuCores) const {
+    std::vector<PCB *> tasks;
+    for (auto process : finishedQueue) {
+        if (process->isPeriodic()) {
+            tasks.push_back(process);
+        }
+    }
+    if (tasks.empty()) {
+        return;
+    }
+
+    std::cout << "\n=== TEMPO REAL (EDF/RM) ===\n";
+    double utilization = 0.0;
+    double observedUtilization = 0.0;
+    int jobs = 0;
+    int misses = 0;
+    for (auto process : tasks) {
+        const RealtimeState &rt = *process->rt;
+        double avgLaxity = rt.laxitySamples
+                               ? static_cast<double>(rt.laxitySum) / rt.laxitySamples
+                               : 0.0;
+        utilization += static_cast<double>(rt.rtWcet) / rt.rtPeriod;
+        observedUtilization += static_cast<double>(rt.maxJobCycles) / rt.rtPeriod;
+        jobs += rt.jobsCompleted;
+        misses += rt.deadlineMisses;
+
+        std::cout << "PID " << process->pid << " (P=" << rt.rtPeriod
+                  << ", D=" << rt.rtDeadline << ", C=" << rt.rtWcet << "): "
+                  << rt.jobsCompleted << " jobs | " << rt.deadlineMisses << " perdidos | "
+                  << "atraso máx " << rt.maxLateness << " (total " << rt.totalTardiness << ") | "
+                  << "folga mín " << rt.minLaxity << ", média " << avgLaxity << " | "
+                  << "maior job " << rt.maxJobCycles << " ciclos\n";
+    }
+
+    const double n = static_cast<double>(tasks.size());
+    uint64_t horizon = 0;
+    for (const auto &core : cpuCores) {
+        horizon = std::max(horizon, core->getQueueStats().clock);
+    }
+    std::cout << "Deadlines perdidos: " << misses << "/" << jobs << " jobs | horizonte "
+              << horizon << " ciclos em " << cpuCores.size() << " núcleos\n";
+    std::cout << "Utilização: declarada (WCET) " << utilization << " | observada (maior job) "
+              << observedUtilization << " | limite RM " << n * (std::pow(2.0, 1.0 / n) - 1.0)
+              << " | limite EDF " << cpuCores.size() << "\n";
+}
+
+// Ponto de preempção: onde e em que estado a fatia deixou o processo
+void Simulator::recordSliceEnd(const PCB &process, std::size_t coreId) {
+    replay.sliceEnd(process.lastRunEnd, process.pid, static_cast<int>(coreId), process.regBank.pc.read(),
+                    static_cast<int>(process.state.load()));
 }
 
 void Simulator::handleCompletion(PCB &process, int &finishedProcesses) {
@@ -256,33 +1161,74 @@ void Simulator::handleCompletion(PCB &process, int &finishedProcesses) {
             //     // std::cout << "[Scheduler] Processo " << process.pid
             //     //         << " bloqueado por I/O. Entregando ao IOManager.\n";
             // }
-            ioManager.registerProcessWaitingForIO(&process);
+            // Instante e contadores no bloqueio: o I/O termina depois dos ciclos cobrados a partir daqui
+            blockRecords[&process] = {process.lastRunEnd, process.io_cycles.load(),
+                                      process.memory_cycles.load(), process.pendingPageFault.load()};
+            if (process.pendingPageFault.load() && config.cpu.pdes) {
+                // Janelas conservadoras: o swap-in acontece aqui, na barreira e em
+                // ordem fixa, e não na thread do IOManager em paralelo aos núcleos
+                memManager.servicePageFault(process.faultAddress.load(), process);
+                process.pendingPageFault.store(false);
+                process.state.store(State::Ready);
+            } else if (process.pendingPageFault.load()) {
+                ioManager.requestPageIn(&process);
+            } else {
+                ioManager.registerProcessWaitingForIO(&process);
+            }
             blockedQueue.push_back(&process);
             break;
         }    
         case State::Finished:{
+            // Tarefa periódica com jobs restantes: o próximo job entra na linha
+            // do tempo na liberação (ou quando o anterior terminou, se atrasou)
+            if (scheduler->releaseNextJob(process)) {
+                if (process.rt->releaseTime > process.lastRunEnd) {
+                    process.rt->releaseWaitCycles += process.rt->releaseTime - process.lastRunEnd;
+                }
+                process.state.store(State::Ready);
+                scheduleReady(process, std::max(process.lastRunEnd, process.rt->releaseTime), SimEventType::JOB_RELEASE);
+                break;
+            }
             
-            // Calcula métricas finais do processo
-            auto finish = std::chrono::high_resolution_clock::now(); // se quiser tempo real
-
-            // Aqui assumimos que você já tem timeStamp como "ciclo final" do processo
-            process.finishTime.store(process.timeStamp);
+            // Métricas finais na linha do tempo simulada (mesmo relógio em todos os núcleos)
+            process.finishTime.store(process.lastRunEnd);
 
             // Turnaround Time = finishTime - arrivalTime
             process.turnaroundTime.store(process.finishTime.load() - process.arrivalTime.load());
 
-            // Waiting Time = turnaroundTime - burstTime
-            process.waitingTime.store(process.turnaroundTime.load() - process.burstTime.load());
+            // Waiting Time = turnaround - tempo executando - tempo bloqueado
+            // (e, em tarefas periódicas, o intervalo até a liberação de cada job)
+            uint64_t busy = process.serviceCycles.load() + process.blockedCycles.load() +
+                            (process.rt ? process.rt->releaseWaitCycles : 0);
+            process.waitingTime.store(process.turnaroundTime.load() > busy ? process.turnaroundTime.load() - busy : 0);
 
             // Response Time = startTime - arrivalTime
             process.responseTime.store(process.startTime.load() - process.arrivalTime.load());
+            if (turnaroundHistogram) {
+                turnaroundHistogram->sample(process.turnaroundTime.load());
+                responseHistogram->sample(process.responseTime.load());
+            }
 
 
+            if (finishedQueue.empty()) {
+                captureContentionShares();
+            }
+
             {
                 std::lock_guard<std::mutex> lock(finishedQueueMutex);
                 finishedQueue.push_back(&process);
             }
             finishedProcesses++;
+
+            // A vaga liberada vai para a chegada mais antiga na fila de admissão
+            if (!admissionQueue.empty()) {
+                PCB *next = admissionQueue.front();
+                admissionQueue.pop_front();
+                scheduleReady(*next, std::max(process.finishTime.load(), next->arrivalTime.load()),
+                              SimEventType::ADMISSION);
+            } else {
+                activeProcesses--;
+            }
             // {
             //     std::lock_guard<std::mutex> lock(printMutex);
             //     std::cout << "[Scheduler] Processo " << process.pid << " finalizado.\n";
@@ -297,38 +1243,13 @@ void Simulator::handleCompletion(PCB &process, int &finishedProcesses) {
             //     // cout << "\n\n\n Iniciando preempção de processos \n\n\n";
 
             // }
-            std::lock_guard<std::mutex> lock(readyQueueMutex);
             process.state.store(State::Ready);
-            readyQueue.push_back(&process);
+            scheduleReady(process, process.lastRunEnd, SimEventType::SLICE_END);
             break;
         }
     }
 }
 
-void Simulator::reclaimFinishedCores(std::vector<std::unique_ptr<CPUCore>> &cpuCores,
-                                     std::vector<PCB *> &coreAssignments,
-                                     std::queue<int> &idleCoresIdx,
-                                     int &finishedProcesses) {
-    for (std::size_t idx = 0; idx < cpuCores.size(); ++idx) {
-        PCB *assigned = coreAssignments[idx];
-        if (!assigned) {
-            continue;
-        }
-        if (!cpuCores[idx]->isIdle()) {
-            continue;
-        }
-
-        handleCompletion(*assigned, finishedProcesses);
-        coreAssignments[idx] = nullptr;
-        idleCoresIdx.push(static_cast<int>(idx));
-    }
-}
-
-bool Simulator::allCoresIdle(const std::vector<PCB *> &coreAssignments) const {
-    return std::all_of(coreAssignments.begin(), coreAssignments.end(), [](PCB *pcb) {
-        return pcb == nullptr;
-    });
-}
 
 void Simulator::collectMemoryMetrics() {
     using namespace std::chrono;
@@ -405,4 +1326,187 @@ void Simulator::saveMemoryMetrics() {
     }
     
     std::cout << "Métricas de memória salvas em: " << filename << "\n";
+}
+
+void Simulator::saveCacheSetMetrics() {
+    const std::string filename = "output/cache_set_heatmap.csv";
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir arquivo para salvar métricas da cache: " << filename << "\n";
+        return;
+    }
+
+    size_t associativity = memManager.getCacheAssociativity();
+    std::vector<CacheSetStats> sets = memManager.getCacheSetStats();
+
+    file << "Set,Accesses,Misses,Evictions,ConflictMisses,VictimHits,MissRate(%),Associativity,VictimCacheSize\n";
+    for (size_t i = 0; i < sets.size(); ++i) {
+        const CacheSetStats &s = sets[i];
+        double missRate = (s.accesses > 0) ? (static_cast<double>(s.misses) / s.accesses * 100.0) : 0.0;
+        file << i << ","
+             << s.accesses << ","
+             << s.misses << ","
+             << s.evictions << ","
+             << s.conflictMisses << ","
+             << s.victimHits << ","
+             << missRate << ","
+             << associativity << ","
+             << config.cache.victim_cache_size << "\n";
+    }
+
+    std::cout << "Histograma por conjunto da cache salvo em: " << filename << "\n";
+}
+
+void Simulator::applyCachePartitioning() {
+    CachePartitionMode mode = static_cast<CachePartitionMode>(std::clamp(config.cache.partition_mode, 0, 2));
+    memManager.setCachePartitioning(mode, static_cast<uint64_t>(std::max(1, config.cache.repartition_interval)));
+
+    if (mode != CachePartitionMode::STATIC) {
+        return;
+    }
+
+    // Precedência: máscara dos metadados da task > PID > prioridade
+    for (auto &process : processList) {
+        if (process->cacheWayMask != 0) {
+            continue;
+        }
+        auto byPid = config.cache.pid_way_masks.find(process->pid);
+        if (byPid != config.cache.pid_way_masks.end()) {
+            process->cacheWayMask = byPid->second;
+            continue;
+        }
+        auto byPriority = config.cache.priority_way_masks.find(process->priority);
+        if (byPriority != config.cache.priority_way_masks.end()) {
+            process->cacheWayMask = byPriority->second;
+        }
+    }
+}
+
+// Carga aberta: carga oferecida, vazão e cauda do tempo de resposta, para
+// montar as curvas vazão x carga e latência x carga variando 'rate'
+void Simulator::printOpenWorkloadSummary(int numCores) const {
+    if (!workload || workload->getMode() == ArrivalMode::STATIC || finishedQueue.empty()) {
+        return;
+    }
+
+    uint64_t firstArrival = std::numeric_limits<uint64_t>::max();
+    uint64_t lastArrival = 0;
+    uint64_t lastFinish = 0;
+    uint64_t totalService = 0;
+    std::vector<uint64_t> turnaround;
+    std::vector<uint64_t> response;
+    for (auto process : finishedQueue) {
+        firstArrival = std::min(firstArrival, process->arrivalTime.load());
+        lastArrival = std::max(lastArrival, process->arrivalTime.load());
+        lastFinish = std::max(lastFinish, process->finishTime.load());
+        totalService += process->serviceCycles.load();
+        turnaround.push_back(process->turnaroundTime.load());
+        response.push_back(process->responseTime.load());
+    }
+
+    const double n = static_cast<double>(finishedQueue.size());
+    double arrivalSpan = static_cast<double>(lastArrival - firstArrival);
+    double offered = arrivalSpan > 0 ? 1000.0 * (n - 1) / arrivalSpan : 0.0;  // Chegadas por 1000 ciclos
+    double meanService = totalService / n;
+    double rho = offered / 1000.0 * meanService / numCores;
+    double span = static_cast<double>(lastFinish - firstArrival);
+    double throughput = span > 0 ? 1000.0 * n / span : 0.0;
+
+    std::cout << "\n=== CARGA ABERTA ===\n";
+    std::cout << "Chegadas: " << arrivalModeName(workload->getMode()) << " | " << workload->getGenerated()
+              << " jobs entre os ciclos " << firstArrival << " e " << lastArrival << "\n";
+    std::cout << "Carga oferecida: " << offered << " jobs/1000 ciclos | serviço médio " << meanService
+              << " ciclos | utilização oferecida (rho) " << rho << "\n";
+    std::cout << "Vazão: " << throughput << " jobs/1000 ciclos\n";
+    std::cout << "Admissões adiadas: " << deferredAdmissions << " (grau de multiprogramação "
+              << config.workload.max_active << ")\n";
+    std::cout << "Turnaround p50/p90/p99/máx: " << percentile(turnaround, 50) << " / "
+              << percentile(turnaround, 90) << " / " << percentile(turnaround, 99) << " / "
+              << percentile(turnaround, 100) << " ciclos\n";
+    std::cout << "Resposta p50/p99: " << percentile(response, 50) << " / " << percentile(response, 99) << " ciclos\n";
+}
+
+void Simulator::saveArrivalMetrics() {
+    if (!workload || workload->getMode() == ArrivalMode::STATIC) {
+        return;
+    }
+
+    const std::string filename = "output/arrivals.csv";
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir arquivo para salvar chegadas: " << filename << "\n";
+        return;
+    }
+
+    file << "PID,Name,Arrival,Start,Finish,Response,Turnaround,Waiting,Service,Blocked,Mode,Rate\n";
+    for (auto process : finishedQueue) {
+        file << process->pid << ","
+             << process->name << ","
+             << process->arrivalTime.load() << ","
+             << process->startTime.load() << ","
+             << process->finishTime.load() << ","
+             << process->responseTime.load() << ","
+             << process->turnaroundTime.load() << ","
+             << process->waitingTime.load() << ","
+             << process->serviceCycles.load() << ","
+             << process->blockedCycles.load() << ","
+             << arrivalModeName(workload->getMode()) << ","
+             << config.workload.rate << "\n";
+    }
+
+    std::cout << "Chegadas e tempos por job salvos em: " << filename << "\n";
+}
+
+void Simulator::saveMigrationMetrics() {
+    const std::string filename = "output/process_migrations.csv";
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir arquivo para salvar migrações: " << filename << "\n";
+        return;
+    }
+
+    file << "PID,Name,Slices,Migrations,MigrationCycles,DistinctCores,Affinity\n";
+    for (const auto &process : processList) {
+        std::set<int> distinct(process->coresAssigned.begin(), process->coresAssigned.end());
+        file << process->pid << ","
+             << process->name << ","
+             << process->coresAssigned.size() << ","
+             << process->migrations.load() << ","
+             << process->migration_cycles.load() << ","
+             << distinct.size() << ","
+             << (config.cpu.affinity == 1 ? "soft" : "off") << "\n";
+    }
+
+    std::cout << "Migrações por processo salvas em: " << filename << "\n";
+}
+
+void Simulator::saveCacheOccupancyMetrics() {
+    const std::string filename = "output/cache_occupancy.csv";
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir arquivo para salvar ocupação da cache: " << filename << "\n";
+        return;
+    }
+
+    std::string mode = partitionModeName(memManager.getCachePartitionMode());
+    std::map<int, CacheOccupancy> occupancy = memManager.getCacheOccupancy();
+
+    file << "PID,Name,WayMask,Lines,PeakLines,AvgLines,Accesses,Misses,MissRate(%),PartitionMode\n";
+    for (const auto &[pid, occ] : occupancy) {
+        PCB *process = memManager.getProcessByPID(pid);
+        double avgLines = (occ.accesses > 0) ? static_cast<double>(occ.lineSamples) / occ.accesses : 0.0;
+        double missRate = (occ.accesses > 0) ? (static_cast<double>(occ.misses) / occ.accesses * 100.0) : 0.0;
+        file << pid << ","
+             << (process ? process->name : "") << ","
+             << hexMask(occ.wayMask) << ","
+             << occ.lines << ","
+             << occ.peakLines << ","
+             << avgLines << ","
+             << occ.accesses << ","
+             << occ.misses << ","
+             << missRate << ","
+             << mode << "\n";
+    }
+
+    std::cout << "Ocupação da cache por processo salva em: " << filename << "\n";
 }
\ No newline at end of file
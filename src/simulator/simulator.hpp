@@ -12,12 +12,16 @@
 #include <thread>
 #include <atomic>
 #include <queue>
+#include <deque>
 #include <ctime>
 #include <filesystem>
+#include <map>
 #include <stdexcept>
+#include <unordered_map>
 
 #include "../cpu/CONTROL_UNIT.hpp"
 #include "../metrics/metrics.hpp"
+#include "../metrics/statsRegistry.hpp"
 #include "../parser_json/parser_json.hpp"
 #include "../system_config/system_config.hpp"
 #include "../cpu/MemoryManager.hpp"
@@ -26,11 +30,38 @@
 #include "../memory/replacementPolicy.hpp"
 #include "../process_scheduler/process_scheduler.hpp"
 #include "../cpu/core.hpp"
+#include "completionQueue.hpp"
+#include "eventTimeline.hpp"
+#include "replayLog.hpp"
+#include "workload.hpp"
+
+// Resultado de uma execução, usado pelo lote de experimentos
+struct RunSummary {
+    std::size_t processes = 0;
+    uint64_t simulatedCycles = 0;
+    double avgWaiting = 0.0;
+    double avgTurnaround = 0.0;
+    double avgResponse = 0.0;
+    double cpuUtilization = 0.0;  // 0..1, normalizada pelos núcleos
+    double throughput = 0.0;      // Processos por 1000 ciclos
+    double cacheHitRate = 0.0;    // 0..1
+    uint64_t migrations = 0;
+    uint64_t deadlineMisses = 0;
+    double jainIndex = 0.0;
+    double wallSeconds = 0.0;
+};
+
+// Programas já montados, indexados pelo caminho do arquivo em src/tasks
+using ProgramCache = std::map<std::string, ProgramImage>;
 
 class Simulator {
 public:
     explicit Simulator(const std::string &configPath = "src/system_config/system_config.json");
+    // Lote de experimentos: configuração montada em memória, programas montados
+    // uma única vez e compartilhados, e nada gravado em output/
+    Simulator(const SystemConfig &systemConfig, std::shared_ptr<const ProgramCache> programs);
     int run();
+    const RunSummary &getSummary() const;
 
 private:
     bool loadProcesses();
@@ -40,13 +71,18 @@ private:
                                uint32_t baseAddress = 0,
                                int pid = 0);
     void moveUnblockedProcesses();
+    void admitNextArrival();
+    void printOpenWorkloadSummary(int numCores) const;
+    void saveArrivalMetrics();
+    void scheduleReady(PCB &process, uint64_t time, SimEventType type);
+    uint64_t safeHorizon(const std::unordered_map<PCB *, uint64_t> &inFlight) const;
+    void releaseDueEvents(uint64_t horizon);
     void executeProcesses();
+    void dispatchEvents(std::vector<std::unique_ptr<CPUCore>> &cpuCores, int &finishedProcesses);
+    void dispatchWindows(std::vector<std::unique_ptr<CPUCore>> &cpuCores, int &finishedProcesses);
+    uint64_t pdesLookahead() const;
     void handleCompletion(PCB &process, int &finishedProcesses);
-    void reclaimFinishedCores(std::vector<std::unique_ptr<CPUCore>> &cpuCores,
-                              std::vector<PCB *> &coreAssignments,
-                              std::queue<int> &idleCoresIdx,
-                              int &finishedProcesses);
-    bool allCoresIdle(const std::vector<PCB *> &coreAssignments) const;
+    void recordSliceEnd(const PCB &process, std::size_t coreId);
 
     struct MemoryUsageRecord {
         long long timestamp;
@@ -57,8 +93,29 @@ private:
     std::vector<MemoryUsageRecord> memoryUsageHistory;
     void collectMemoryMetrics();
     void saveMemoryMetrics();
+    void saveCacheSetMetrics();
+    void applyCachePartitioning();
+    void saveCacheOccupancyMetrics();
+    void saveMigrationMetrics();
+    int selectCore(const PCB &process,
+                   const std::vector<std::unique_ptr<CPUCore>> &cpuCores,
+                   int &nextCore) const;
+    void printMlfqSummary() const;
+    void printRealtimeSummary(const std::vector<std::unique_ptr<CPUCore>> &cpuCores) const;
+    void printLatencySummary(const std::vector<std::unique_ptr<CPUCore>> &cpuCores) const;
+    void captureContentionShares();
+    bool statsEnabled() const;
+    void registerProcessStats(PCB &process);
+    void registerSystemStats(const std::vector<std::unique_ptr<CPUCore>> &cpuCores);
+    uint64_t statsClock() const;
+    void updateStats();
+    void saveStats();
+    static double jainIndex(const std::vector<double> &shares);
 
     SystemConfig config;
+    std::shared_ptr<const ProgramCache> programs;
+    bool writeOutputs = true;
+    RunSummary summary;
     MemoryManager memManager;
 
     std::vector<std::unique_ptr<PCB>> processList;
@@ -67,10 +124,46 @@ private:
     std::vector<PCB *> blockedQueue;
     mutable std::mutex blockedQueueMutex;
     std::vector<PCB *> finishedQueue;
+    std::vector<double> contentionShares; // CPU/peso de cada processo no 1º término
     mutable std::mutex finishedQueueMutex;
     std::unique_ptr<ProcessScheduler> scheduler;
     mutable std::mutex printMutex;
     IOManager ioManager;
+    CompletionQueue completionQueue; // Eventos de núcleo livre e de desbloqueio
+    // Carga aberta: modelos (nome, arquivo) e gerador de chegadas
+    std::vector<std::pair<std::string, std::string>> templates;
+    std::unique_ptr<WorkloadGenerator> workload;
+    std::deque<PCB *> admissionQueue; // Chegadas aguardando vaga (workload.max_active)
+    int activeProcesses = 0;          // Admitidos e ainda não finalizados
+    uint64_t deferredAdmissions = 0;
+
+    EventTimeline timeline;          // Relógio global: instantes em que os processos ficam prontos
+    ReplayLog replay;                // Gravação/repetição das decisões (simulation.replay)
+
+    // Registro de estatísticas (simulation.stats): aquecimento e retratos no relógio simulado
+    StatsRegistry stats;
+    StatHistogram *turnaroundHistogram = nullptr;
+    StatHistogram *responseHistogram = nullptr;
+    bool statsWarmedUp = false;
+    uint64_t nextStatsDump = 0;
+
+    // Janelas conservadoras (cpu.pdes)
+    struct PdesStats {
+        uint64_t windows = 0;
+        uint64_t slices = 0;
+        uint64_t activeCores = 0;    // Soma, por janela, dos núcleos que receberam fatias
+        std::size_t maxActiveCores = 0;
+    };
+    PdesStats pdesStats;
+
+    // Bloqueio em andamento: instante e contadores de I/O e memória no momento
+    struct BlockRecord {
+        uint64_t since = 0;
+        uint64_t ioCycles = 0;
+        uint64_t memoryCycles = 0;
+        bool pageFault = false;
+    };
+    std::unordered_map<PCB *, BlockRecord> blockRecords;
 };
 
 #endif // SIMULATOR_HPP
@@ -0,0 +1,150 @@
+#include "workload.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+namespace {
+std::string trim(const std::string &text) {
+    std::size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    std::size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+} // namespace
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadConfig &config, const std::vector<std::string> &templateNames)
+    : config(config),
+      mode(static_cast<ArrivalMode>(config.mode)),
+      templateCount(templateNames.size()),
+      rng(config.seed) {
+    if (mode == ArrivalMode::TRACE) {
+        loadTrace(config.trace_file, templateNames);
+    }
+}
+
+// CSV "ciclo,task"; linhas vazias, comentários (#) e cabeçalho são ignorados.
+// A task pode ser o nome do arquivo (com ou sem .json) ou o índice do modelo.
+void WorkloadGenerator::loadTrace(const std::string &path, const std::vector<std::string> &templateNames) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Aviso: trace de chegadas '" << path << "' não encontrado.\n";
+        return;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::size_t comma = line.find(',');
+        std::string timeField = trim(line.substr(0, comma));
+        std::string taskField = comma == std::string::npos ? "" : trim(line.substr(comma + 1));
+        if (timeField.empty() || !std::isdigit(static_cast<unsigned char>(timeField[0]))) {
+            continue;  // Cabeçalho
+        }
+
+        std::size_t index = templateNames.size();
+        for (std::size_t i = 0; i < templateNames.size(); ++i) {
+            const std::string &name = templateNames[i];
+            if (name == taskField || name == taskField + ".json") {
+                index = i;
+                break;
+            }
+        }
+        if (index == templateNames.size() && !taskField.empty() &&
+            std::all_of(taskField.begin(), taskField.end(), ::isdigit)) {
+            index = std::stoul(taskField);
+        }
+        if (index >= templateNames.size()) {
+            std::cerr << "Aviso: " << path << ":" << lineNumber << ": task '" << taskField
+                      << "' desconhecida, linha ignorada.\n";
+            continue;
+        }
+
+        trace.push_back({std::stoull(timeField), index});
+    }
+
+    std::stable_sort(trace.begin(), trace.end(), [](const Arrival &a, const Arrival &b) {
+        return a.time < b.time;
+    });
+}
+
+// Intervalo exponencial; no on-off, uma chegada que cairia no período
+// desligado é descartada e o sorteio recomeça no próximo período ligado
+// (válido porque a exponencial não tem memória)
+uint64_t WorkloadGenerator::nextRandomTime() {
+    double meanGap = 1000.0 / std::max(config.rate, 1e-9);
+    std::exponential_distribution<double> gap(1.0 / meanGap);
+
+    if (mode != ArrivalMode::ON_OFF || config.on_duration == 0) {
+        clock += gap(rng);
+        return static_cast<uint64_t>(std::llround(clock));
+    }
+
+    const double on = static_cast<double>(config.on_duration);
+    const double period = on + static_cast<double>(config.off_duration);
+    while (true) {
+        double candidate = clock + gap(rng);
+        double phase = std::fmod(candidate, period);
+        if (phase < on) {
+            clock = candidate;
+            return static_cast<uint64_t>(std::llround(clock));
+        }
+        clock = candidate - phase + period;  // Início do próximo período ligado
+    }
+}
+
+bool WorkloadGenerator::next(Arrival &arrival) {
+    if (templateCount == 0 || mode == ArrivalMode::STATIC) {
+        return false;
+    }
+    if (config.max_jobs > 0 && generated >= static_cast<uint64_t>(config.max_jobs)) {
+        return false;
+    }
+
+    if (mode == ArrivalMode::TRACE) {
+        if (traceCursor >= trace.size()) {
+            return false;
+        }
+        arrival = trace[traceCursor++];
+    } else {
+        arrival.time = nextRandomTime();
+        arrival.templateIndex = std::uniform_int_distribution<std::size_t>(0, templateCount - 1)(rng);
+    }
+
+    if (config.horizon_cycles > 0 && arrival.time > config.horizon_cycles) {
+        return false;
+    }
+    generated++;
+    return true;
+}
+
+uint64_t WorkloadGenerator::getGenerated() const {
+    return generated;
+}
+
+ArrivalMode WorkloadGenerator::getMode() const {
+    return mode;
+}
+
+const char *arrivalModeName(ArrivalMode mode) {
+    switch (mode) {
+        case ArrivalMode::POISSON:
+            return "Poisson";
+        case ArrivalMode::ON_OFF:
+            return "On-off";
+        case ArrivalMode::TRACE:
+            return "Trace";
+        default:
+            return "Estático";
+    }
+}
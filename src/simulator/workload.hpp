@@ -0,0 +1,65 @@
+#ifndef WORKLOAD_HPP
+#define WORKLOAD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../system_config/system_config.hpp"
+
+/*
+  Gerador de chegadas para carga aberta. Produz, em ordem de tempo simulado,
+  o instante de cada chegada e o modelo (programa de src/tasks) a instanciar:
+
+    Poisson -> intervalos exponenciais com média 1000/rate ciclos
+    On-off  -> Poisson durante on_duration, nenhuma chegada durante off_duration
+    Trace   -> linhas "ciclo,task" de um CSV (task = nome do arquivo do modelo)
+
+  Nos modos aleatórios o modelo é sorteado de forma uniforme. A mesma semente
+  produz sempre a mesma sequência.
+*/
+
+enum class ArrivalMode {
+    STATIC = 0,
+    POISSON = 1,
+    ON_OFF = 2,
+    TRACE = 3
+};
+
+struct Arrival {
+    uint64_t time = 0;
+    std::size_t templateIndex = 0;
+};
+
+class WorkloadGenerator {
+   public:
+    // templateNames: nome de arquivo de cada modelo, na mesma ordem dos índices
+    WorkloadGenerator(const WorkloadConfig &config, const std::vector<std::string> &templateNames);
+
+    // Próxima chegada; false quando o horizonte (tempo ou jobs) foi atingido
+    bool next(Arrival &arrival);
+
+    uint64_t getGenerated() const;
+    ArrivalMode getMode() const;
+
+   private:
+    void loadTrace(const std::string &path, const std::vector<std::string> &templateNames);
+    uint64_t nextRandomTime();
+
+    WorkloadConfig config;
+    ArrivalMode mode;
+    std::size_t templateCount;
+    std::mt19937_64 rng;
+
+    double clock = 0.0;  // Instante da última chegada (modos aleatórios)
+    uint64_t generated = 0;
+
+    std::vector<Arrival> trace;
+    std::size_t traceCursor = 0;
+};
+
+const char *arrivalModeName(ArrivalMode mode);
+
+#endif
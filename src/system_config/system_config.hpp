@@ -1,9 +1,12 @@
 #ifndef SYSTEM_CONFIG_HPP
 #define SYSTEM_CONFIG_HPP
 
+#include <cstdint>
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <vector>
 #include "../nlohmann/json.hpp" 
 
 using json = nlohmann::json;
@@ -13,6 +16,9 @@ struct MainMemoryConfig {
     int page_size;
     int weight;
     int policy;
+    bool page_sharing;  // Compartilha páginas idênticas entre processos (copy-on-write)
+    bool async_page_faults; // Page fault bloqueia o processo e o swap-in vai para o IOManager
+    bool demand_paging; // Páginas do programa preenchidas no primeiro acesso, e não na carga
 };
 
 struct SecondaryMemoryConfig {
@@ -26,14 +32,94 @@ struct CacheConfig {
     int line_size;
     int weight;
     int policy;
+    int write_policy;       // 0 = write-back, 1 = write-through
+    bool write_allocate;    // Aloca linha em write miss?
+    int write_buffer_size;  // Entradas do write buffer (0 = desabilitado)
+    int associativity;      // Vias por conjunto (0 = totalmente associativa)
+    int victim_cache_size;  // Entradas da victim cache (0 = desabilitada)
+
+    // Particionamento de vias (QoS): 0 = desligado, 1 = máscaras estáticas, 2 = por utilidade
+    int partition_mode;
+    int repartition_interval;                 // Acessos entre reparticionamentos (modo 2)
+    std::map<int, uint64_t> pid_way_masks;     // PID -> máscara de vias
+    std::map<int, uint64_t> priority_way_masks; // Prioridade -> máscara de vias
 };
 
 struct CpuConfig {
     int cores;
+    int affinity;           // 0 = sem afinidade (rodízio), 1 = afinidade suave
+    int migration_penalty;  // Ciclos cobrados ao executar fora do último núcleo
+    int affinity_imbalance; // Excesso de carga tolerado no último núcleo antes de migrar
+    bool pdes;              // Janelas conservadoras: núcleos sincronizados nas fronteiras
+    int pdes_lookahead;     // Largura da janela em ciclos (0 = latência da memória principal)
+};
+
+struct MlfqConfig {
+    int levels;               // Número de níveis (1..MLFQ_MAX_LEVELS)
+    std::vector<int> quanta;  // Quantum de cada nível, em ciclos
+    int boost_interval;       // Fatias concluídas entre dois boosts (0 = sem boost)
+};
+
+struct CfsConfig {
+    int target_latency;   // Ciclos em que todos os prontos devem executar uma vez
+    int min_granularity;  // Fatia mínima, em ciclos
+};
+
+struct RealtimeConfig {
+    int quantum;  // Fatia do EDF/RM; ao fim dela a fila é reavaliada
+    int jobs;     // Jobs por tarefa periódica sem 'jobs' no metadata
 };
 
 struct SchedulingConfig {
     int algorithm;  
+    MlfqConfig mlfq;
+    CfsConfig cfs;
+    RealtimeConfig realtime;
+};
+
+// Carga aberta: processos chegam ao longo do tempo simulado, instanciados a
+// partir dos programas de src/tasks (modelos)
+struct WorkloadConfig {
+    int mode;                  // 0 = estático (todas as tasks em t=0), 1 = Poisson, 2 = on-off, 3 = trace
+    double rate;               // Chegadas por 1000 ciclos (no on-off, durante o período ligado)
+    uint64_t on_duration;      // On-off: ciclos do período com chegadas
+    uint64_t off_duration;     // On-off: ciclos do período sem chegadas
+    std::string trace_file;    // Trace: CSV "ciclo,task"
+    unsigned seed;             // Semente dos intervalos e da escolha do modelo (0 = derivada de simulation.seed)
+    uint64_t horizon_cycles;   // Nenhuma chegada depois deste instante (0 = sem limite)
+    int max_jobs;              // Nenhuma chegada depois deste número de jobs (0 = sem limite)
+    int max_active;            // Grau de multiprogramação: acima dele a chegada espera admissão (0 = sem limite)
+};
+
+// Fluxos de números aleatórios derivados da semente mestre
+enum class SeedStream : uint64_t {
+    SCHEDULER = 1,  // Sorteio da loteria na lista global
+    READY_QUEUE,    // Loteria na fila de cada núcleo (índice = núcleo)
+    QUANTUM,        // Quantum inicial de cada processo (índice = posição)
+    PRIORITY,       // Prioridade inicial de cada processo (índice = posição)
+    IO_DEVICES,     // Pedidos e custos dos dispositivos no IOManager
+    WORKLOAD        // Chegadas da carga aberta
+};
+
+// Semente de um fluxo (splitmix64): fluxos e índices diferentes não se correlacionam
+inline uint64_t deriveSeed(uint64_t master, SeedStream stream, uint64_t index = 0) {
+    uint64_t z = master + 0x9E3779B97F4A7C15ull * (static_cast<uint64_t>(stream) * 0x10001ull + index + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Reprodutibilidade: uma semente alimenta todos os geradores, e o log de
+// eventos permite gravar uma execução e repeti-la com as mesmas decisões
+struct SimulationConfig {
+    uint64_t seed;
+    bool deterministic;       // Janelas conservadoras, um núcleo por vez e pipeline sem busca especulativa
+    int replay_mode;          // 0 = desligado, 1 = grava o log, 2 = repete o log
+    std::string replay_file;  // Log de eventos (CSV)
+    std::string image_cache;  // Diretório das imagens binárias dos programas ("" = sempre monta)
+    std::string stats_file;   // Registro de estatísticas (.json ou .csv; "" = não grava)
+    uint64_t stats_warmup_cycles;  // Zera as estatísticas neste ciclo (0 = sem aquecimento)
+    uint64_t stats_dump_interval;  // Retrato a cada N ciclos, além do final (0 = só o final)
 };
 
 class SystemConfig {
@@ -43,6 +129,26 @@ public:
     CacheConfig cache;
     CpuConfig cpu;
     SchedulingConfig scheduling;
+    WorkloadConfig workload;
+    SimulationConfig simulation;
+
+    // Máscara de vias: número inteiro ou string decimal/hexadecimal ("0x3")
+    static uint64_t parseWayMask(const json& value) {
+        if (value.is_string()) {
+            return std::stoull(value.get<std::string>(), nullptr, 0);
+        }
+        return value.get<uint64_t>();
+    }
+
+    static std::map<int, uint64_t> parseWayMasks(const json& node, const char* field) {
+        std::map<int, uint64_t> masks;
+        if (node.contains(field)) {
+            for (const auto& [key, value] : node.at(field).items()) {
+                masks[std::stoi(key)] = parseWayMask(value);
+            }
+        }
+        return masks;
+    }
 
     static SystemConfig loadFromFile(const std::string& filePath) {
         std::ifstream file(filePath);
@@ -52,13 +158,20 @@ public:
 
         json j;
         file >> j;
+        return fromJson(j);
+    }
 
+    // Documento já lido (o lote de experimentos monta cada ponto da varredura em memória)
+    static SystemConfig fromJson(const json& j) {
         SystemConfig config;
 
         config.main_memory.total = j.at("main_memory").at("total").get<int>();
         config.main_memory.page_size = j.at("main_memory").at("page_size").get<int>();
         config.main_memory.weight = j.at("main_memory").at("weight").get<int>();
         config.main_memory.policy = j.at("main_memory").at("policy").get<int>();
+        config.main_memory.page_sharing = j.at("main_memory").value("page_sharing", false);
+        config.main_memory.async_page_faults = j.at("main_memory").value("async_page_faults", false);
+        config.main_memory.demand_paging = j.at("main_memory").value("demand_paging", false);
 
         config.secondary_memory.total = j.at("secondary_memory").at("total").get<int>();
         config.secondary_memory.block_size = j.at("secondary_memory").at("block_size").get<int>();
@@ -68,11 +181,65 @@ public:
         config.cache.line_size = j.at("cache").at("line_size").get<int>();
         config.cache.weight = j.at("cache").at("weight").get<int>();
         config.cache.policy = j.at("cache").at("policy").get<int>();
+        config.cache.write_policy = j.at("cache").value("write_policy", 0);
+        config.cache.write_allocate = j.at("cache").value("write_allocate", true);
+        config.cache.write_buffer_size = j.at("cache").value("write_buffer_size", 0);
+        config.cache.associativity = j.at("cache").value("associativity", 0);
+        config.cache.victim_cache_size = j.at("cache").value("victim_cache_size", 0);
+
+        json partitioning = j.at("cache").value("partitioning", json::object());
+        config.cache.partition_mode = partitioning.value("mode", 0);
+        config.cache.repartition_interval = partitioning.value("repartition_interval", 256);
+        config.cache.pid_way_masks = parseWayMasks(partitioning, "pid_masks");
+        config.cache.priority_way_masks = parseWayMasks(partitioning, "priority_masks");
 
         config.cpu.cores = j.at("cpu").at("cores").get<int>();
+        json affinity = j.at("cpu").value("affinity", json::object());
+        config.cpu.affinity = affinity.value("mode", 1);
+        config.cpu.migration_penalty = affinity.value("migration_penalty", 20);
+        config.cpu.affinity_imbalance = affinity.value("imbalance", 2);
+        json pdes = j.at("cpu").value("pdes", json::object());
+        config.cpu.pdes = pdes.value("enabled", false);
+        config.cpu.pdes_lookahead = pdes.value("lookahead", 0);
 
         config.scheduling.algorithm = j.at("scheduling").at("algorithm").get<int>();
 
+        json mlfq = j.at("scheduling").value("mlfq", json::object());
+        config.scheduling.mlfq.levels = mlfq.value("levels", 3);
+        config.scheduling.mlfq.quanta = mlfq.value("quanta", std::vector<int>{8, 16, 32});
+        config.scheduling.mlfq.boost_interval = mlfq.value("boost_interval", 32);
+
+        json cfs = j.at("scheduling").value("cfs", json::object());
+        config.scheduling.cfs.target_latency = cfs.value("target_latency", 48);
+        config.scheduling.cfs.min_granularity = cfs.value("min_granularity", 6);
+
+        json realtime = j.at("scheduling").value("realtime", json::object());
+        config.scheduling.realtime.quantum = realtime.value("quantum", 16);
+        config.scheduling.realtime.jobs = realtime.value("jobs", 4);
+
+        json workload = j.value("workload", json::object());
+        config.workload.mode = workload.value("mode", 0);
+        config.workload.rate = workload.value("rate", 1.0);
+        config.workload.on_duration = workload.value("on_duration", uint64_t{2000});
+        config.workload.off_duration = workload.value("off_duration", uint64_t{4000});
+        config.workload.trace_file = workload.value("trace_file", std::string("src/workload/trace_example.csv"));
+        config.workload.seed = workload.value("seed", 0u);
+        config.workload.horizon_cycles = workload.value("horizon_cycles", uint64_t{0});
+        config.workload.max_jobs = workload.value("max_jobs", 20);
+        config.workload.max_active = workload.value("max_active", 4);
+
+        json simulation = j.value("simulation", json::object());
+        config.simulation.seed = simulation.value("seed", uint64_t{42});
+        config.simulation.deterministic = simulation.value("deterministic", false);
+        json replay = simulation.value("replay", json::object());
+        config.simulation.replay_mode = replay.value("mode", 0);
+        config.simulation.replay_file = replay.value("file", std::string("output/replay_log.csv"));
+        config.simulation.image_cache = simulation.value("image_cache", std::string("output/program_cache"));
+        json stats = simulation.value("stats", json::object());
+        config.simulation.stats_file = stats.value("file", std::string("output/stats.json"));
+        config.simulation.stats_warmup_cycles = stats.value("warmup_cycles", uint64_t{0});
+        config.simulation.stats_dump_interval = stats.value("dump_interval", uint64_t{0});
+
         return config;
     }
 };